@@ -0,0 +1,259 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include "Admission.hpp"
+#include "Program.hpp"
+#include "Event.hpp"
+#include "Clock.hpp"
+
+#define NSEC_PER_SEC 1000000000.0
+
+bool gaggled::Admission::Held::operator<(const Held& other) const {
+  if (depth != other.depth)
+    return depth < other.depth;
+  return seq < other.seq;
+}
+
+gaggled::Admission::Admission() :
+  limited(false),
+  seq(0)
+{
+  global.name = "gaggled";
+  global.maxstarting = 0;
+  global.startrate = 0;
+  global.starting = 0;
+  global.next_start = 0;
+}
+
+gaggled::Admission::~Admission() {
+  clear();
+}
+
+void gaggled::Admission::set_global(int maxstarting, double startrate) {
+  global.maxstarting = maxstarting;
+  global.startrate = startrate;
+  limited = limited or maxstarting > 0 or startrate > 0;
+}
+
+int gaggled::Admission::add_group(std::string name, int maxstarting, double startrate) {
+  AdmissionLimit l;
+  l.name = name;
+  l.maxstarting = maxstarting;
+  l.startrate = startrate;
+  l.starting = 0;
+  l.next_start = 0;
+  groups.push_back(l);
+  limited = limited or maxstarting > 0 or startrate > 0;
+  return groups.size() - 1;
+}
+
+int gaggled::Admission::find_group(std::string name) {
+  for (size_t i = 0; i != groups.size(); i++)
+    if (groups[i].name == name)
+      return i;
+  return -1;
+}
+
+bool gaggled::Admission::is_limited() {
+  return limited;
+}
+
+gaggled::AdmissionLimit* gaggled::Admission::group_of(Program* p) {
+  int g = p->get_group();
+  if (g < 0)
+    return NULL;
+  return &groups[g];
+}
+
+bool gaggled::Admission::fits(AdmissionLimit* l, uint64_t now) {
+  if (l->maxstarting > 0 and l->starting >= l->maxstarting)
+    return false;
+  if (l->startrate > 0 and now < l->next_start)
+    return false;
+  return true;
+}
+
+void gaggled::Admission::take(AdmissionLimit* l, uint64_t now) {
+  l->starting++;
+  if (l->startrate > 0) {
+    if (l->next_start < now)
+      l->next_start = now;
+    l->next_start += (uint64_t) (NSEC_PER_SEC / l->startrate);
+  }
+}
+
+void gaggled::Admission::give_back(AdmissionLimit* l) {
+  if (l->starting > 0)
+    l->starting--;
+}
+
+bool gaggled::Admission::try_reserve(Program* p) {
+  uint64_t now = gaggled::Clock::now();
+  AdmissionLimit* group = group_of(p);
+  if (not fits(&global, now))
+    return false;
+  if (group != NULL and not fits(group, now))
+    return false;
+
+  take(&global, now);
+  if (group != NULL)
+    take(group, now);
+  p->set_admission(ADMIT_RESERVED);
+  return true;
+}
+
+bool gaggled::Admission::bounded(AdmissionLimit* l) {
+  return l != NULL and (l->maxstarting > 0 or l->startrate > 0);
+}
+
+bool gaggled::Admission::queued_ahead(Program* p) {
+  // a held start is ahead of p if they wait on the same group, or if it's waiting on
+  // the global limit rather than its own group's, as p would have to.
+  uint64_t now = gaggled::Clock::now();
+  AdmissionLimit* group = group_of(p);
+  bool grouped = bounded(group);
+  bool global_bound = bounded(&global);
+  for (auto h = held.begin(); h != held.end(); h++) {
+    if (h->e->is_cancelled())
+      continue;
+    AdmissionLimit* theirs = group_of(h->e->get_program_pointer());
+    if (grouped and theirs == group)
+      return true;
+    if (global_bound and (theirs == NULL or fits(theirs, now)))
+      return true;
+  }
+  return false;
+}
+
+bool gaggled::Admission::admit(Event* e) {
+  if (not limited)
+    return true;
+  Program* p = e->get_program_pointer();
+  if (p->get_admission() != ADMIT_NONE)
+    return true;
+
+  // nothing jumps the queue of starts already held back for a slot it needs too; a
+  // start that competes with none of them goes ahead if it fits.
+  if (not queued_ahead(p) and try_reserve(p))
+    return true;
+
+  Held h;
+  h.depth = p->get_depth();
+  h.seq = seq++;
+  h.e = e;
+  held.insert(h);
+  return false;
+}
+
+void gaggled::Admission::started(Program* p) {
+  if (p->get_admission() != ADMIT_RESERVED)
+    return;
+  if (p->is_running() or p->is_spawning()) {
+    p->set_admission(ADMIT_STARTING);
+    starting.push_back(p);
+  } else {
+    forfeit(p);
+  }
+}
+
+void gaggled::Admission::forfeit(Program* p) {
+  if (p->get_admission() != ADMIT_RESERVED)
+    return;
+
+  give_back(&global);
+  AdmissionLimit* group = group_of(p);
+  if (group != NULL)
+    give_back(group);
+  p->set_admission(ADMIT_NONE);
+}
+
+void gaggled::Admission::release() {
+  // a program stops counting as starting once it's been up for its ready time, or if
+  // it's gone down again before getting there.
+  for (size_t i = 0; i < starting.size(); ) {
+    Program* p = starting[i];
+    if (p->is_spawning() or (p->is_running() and not p->is_up(p->get_ready()))) {
+      i++;
+      continue;
+    }
+    starting[i] = starting.back();
+    starting.pop_back();
+    give_back(&global);
+    AdmissionLimit* group = group_of(p);
+    if (group != NULL)
+      give_back(group);
+    p->set_admission(ADMIT_NONE);
+  }
+
+  // shallowest first. one group being full doesn't hold back the others, but once
+  // everything is full there's no point looking further.
+  uint64_t now = gaggled::Clock::now();
+  for (auto h = held.begin(); h != held.end() and fits(&global, now); ) {
+    Event* e = h->e;
+    if (e->is_cancelled()) {
+      held.erase(h++);
+      delete e;
+    } else if (try_reserve(e->get_program_pointer())) {
+      held.erase(h++);
+      e->queue();
+    } else {
+      h++;
+    }
+  }
+}
+
+long gaggled::Admission::usec_until_release() {
+  if (held.empty())
+    return -1;
+
+  uint64_t now = gaggled::Clock::now();
+  uint64_t soonest = 0;
+  for (auto s = starting.begin(); s != starting.end(); s++) {
+    // spawn results wake the loop by themselves
+    if (not (*s)->is_running())
+      continue;
+    uint64_t at = (*s)->up_at((*s)->get_ready());
+    if (soonest == 0 or at < soonest)
+      soonest = at;
+  }
+  if (global.startrate > 0 and global.next_start > now and (soonest == 0 or global.next_start < soonest))
+    soonest = global.next_start;
+  for (auto l = groups.begin(); l != groups.end(); l++)
+    if (l->startrate > 0 and l->next_start > now and (soonest == 0 or l->next_start < soonest))
+      soonest = l->next_start;
+
+  if (soonest == 0)
+    return -1;
+  if (soonest <= now)
+    return 0;
+  return (soonest - now + NSEC_PER_USEC - 1) / NSEC_PER_USEC;
+}
+
+size_t gaggled::Admission::held_count() {
+  return held.size();
+}
+
+void gaggled::Admission::clear() {
+  for (auto h = held.begin(); h != held.end(); h++)
+    delete h->e;
+  held.clear();
+  starting.clear();
+}
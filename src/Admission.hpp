@@ -0,0 +1,96 @@
+#ifndef GAGGLED_ADMISSION_HPP_INCLUDED
+#define GAGGLED_ADMISSION_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <set>
+
+#define ADMIT_NONE 0
+#define ADMIT_RESERVED 1
+#define ADMIT_STARTING 2
+
+namespace gaggled {
+class Program;
+class Event;
+
+// how many programs may be starting at once and how fast they may be started, for
+// everything or for one group. 0 means no limit.
+struct AdmissionLimit {
+  std::string name;
+  int maxstarting;
+  double startrate;
+  int starting;
+  uint64_t next_start;
+};
+
+// start admission control. a start that would go over a limit is held here instead of
+// being run, and held starts are let go shallowest in the dependency graph first as
+// started programs become ready (up for their ready time) or the start rate allows.
+class Admission
+{
+public:
+  Admission();
+  ~Admission();
+  void set_global(int maxstarting, double startrate);
+  int add_group(std::string name, int maxstarting, double startrate);
+  int find_group(std::string name);
+  bool is_limited();
+  // true if e may start its program now; otherwise e is held and false returned.
+  bool admit(Event* e);
+  // after e's program was started, or not.
+  void started(Program* p);
+  // the start admit() let through didn't happen.
+  void forfeit(Program* p);
+  // retire ready programs and queue whatever held starts now fit.
+  void release();
+  // how long until release() could let something go, -1 if never.
+  long usec_until_release();
+  size_t held_count();
+  void clear();
+private:
+  struct Held {
+    size_t depth;
+    uint64_t seq;
+    Event* e;
+    bool operator<(const Held& other) const;
+  };
+  AdmissionLimit global;
+  std::vector<AdmissionLimit> groups;
+  std::vector<Program*> starting;
+  bool limited;
+  std::set<Held> held;
+  uint64_t seq;
+  bool fits(AdmissionLimit* l, uint64_t now);
+  void take(AdmissionLimit* l, uint64_t now);
+  void give_back(AdmissionLimit* l);
+  AdmissionLimit* group_of(Program* p);
+  bool try_reserve(Program* p);
+  bool bounded(AdmissionLimit* l);
+  bool queued_ahead(Program* p);
+};
+}
+
+#endif
@@ -0,0 +1,94 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stdlib.h>
+#include <unistd.h>
+#include "Backoff.hpp"
+#include "Clock.hpp"
+
+gaggled::BackoffPolicy gaggled::Backoff::default_policy() {
+  BackoffPolicy policy;
+  policy.initial = 0;
+  policy.multiplier = 2.0;
+  policy.max = 60000;
+  policy.jitter = 0.2;
+  policy.stable = 10000;
+  return policy;
+}
+
+gaggled::ChurnPolicy gaggled::Backoff::default_churn() {
+  ChurnPolicy churn;
+  churn.deaths = 0;
+  churn.window = 60000;
+  churn.pause = 60000;
+  return churn;
+}
+
+gaggled::Backoff::Backoff() :
+  policy(default_policy()),
+  delay(0),
+  jittered(0)
+{
+  // programs that die together shouldn't all draw the same jitter.
+  seed = (unsigned int) (gaggled::Clock::update() ^ ((uint64_t) (uintptr_t) this) ^ getpid());
+}
+
+void gaggled::Backoff::set_policy(const gaggled::BackoffPolicy& policy) {
+  this->policy = policy;
+  this->delay = 0;
+  this->jittered = 0;
+}
+
+const gaggled::BackoffPolicy& gaggled::Backoff::get_policy() {
+  return policy;
+}
+
+int gaggled::Backoff::next(uint64_t up_ms) {
+  if (policy.initial <= 0)
+    return 0;
+
+  // a program that stayed up long enough starts over from the initial delay.
+  if (delay == 0 or up_ms >= (uint64_t) policy.stable) {
+    delay = policy.initial;
+  } else {
+    double grown = delay * policy.multiplier;
+    delay = (grown >= policy.max) ? policy.max : (int) grown;
+  }
+
+  if (policy.jitter <= 0)
+    return (jittered = delay);
+
+  // spread by up to jitter either way.
+  double r = (double) rand_r(&seed) / RAND_MAX;
+  double spread = delay * (1.0 - policy.jitter + 2.0 * policy.jitter * r);
+  return (jittered = (spread < 1.0) ? 1 : (int) spread);
+}
+
+int gaggled::Backoff::current(uint64_t up_ms) {
+  if (policy.initial <= 0 or up_ms >= (uint64_t) policy.stable)
+    return 0;
+  return jittered;
+}
+
+void gaggled::Backoff::reset() {
+  delay = 0;
+  jittered = 0;
+}
@@ -0,0 +1,75 @@
+#ifndef GAGGLED_BACKOFF_HPP_INCLUDED
+#define GAGGLED_BACKOFF_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stdint.h>
+
+namespace gaggled {
+
+// how long to wait before respawning a program that died. initial is the first delay
+// in ms, 0 for none, each death before the program was up for stable ms multiplies it
+// by multiplier up to max, and jitter is the fraction it's randomly moved by either way.
+struct BackoffPolicy {
+  int initial;
+  double multiplier;
+  int max;
+  double jitter;
+  int stable;
+};
+
+// a program that dies deaths times within window ms is churning, and isn't restarted
+// again for pause ms, or at all if pause is 0, unless an operator starts it. 0 deaths
+// turns this off.
+struct ChurnPolicy {
+  int deaths;
+  int window;
+  int pause;
+};
+
+class Backoff
+{
+public:
+  Backoff();
+  // off, but doubling to a minute and reset after 10s up once turned on.
+  static BackoffPolicy default_policy();
+  // off; given a number of deaths, that many in a minute pauses restarts for a minute.
+  static ChurnPolicy default_churn();
+  void set_policy(const BackoffPolicy& policy);
+  const BackoffPolicy& get_policy();
+  // the delay in ms before respawning a program that died after up_ms of running.
+  int next(uint64_t up_ms);
+  // the backoff in effect for a program that has been running up_ms, 0 if none: the
+  // delay next() last handed out, jitter and all.
+  int current(uint64_t up_ms);
+  void reset();
+private:
+  BackoffPolicy policy;
+  // the un-jittered delay last used, 0 before the first death or after a reset
+  int delay;
+  // and what it came to with jitter
+  int jittered;
+  unsigned int seed;
+};
+}
+
+#endif
@@ -0,0 +1,42 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <time.h>
+#include <iostream>
+#include "Clock.hpp"
+
+uint64_t gaggled::Clock::cached = 0;
+
+uint64_t gaggled::Clock::now() {
+  if (cached == 0)
+    return update();
+  return cached;
+}
+
+uint64_t gaggled::Clock::update() {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+    std::cout << "error: failed to clock_gettime(CLOCK_MONOTONIC), timing behaviour warning." << std::endl;
+    return cached;
+  }
+  cached = (uint64_t) ts.tv_sec * static_cast<uint64_t>(1000000000) + (uint64_t) ts.tv_nsec;
+  return cached;
+}
@@ -0,0 +1,44 @@
+#ifndef GAGGLED_CLOCK_HPP_INCLUDED
+#define GAGGLED_CLOCK_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stdint.h>
+
+#define NSEC_PER_MSEC static_cast<uint64_t>(1000000)
+#define NSEC_PER_USEC static_cast<uint64_t>(1000)
+
+namespace gaggled {
+// monotonic time in nanoseconds, used for all scheduling and uptime math so that
+// wall clock steps can't stall or fire delays.  the event loop reads the clock once
+// per pass with update(), everything else uses the cached now().
+class Clock
+{
+public:
+  static uint64_t now();
+  static uint64_t update();
+private:
+  static uint64_t cached;
+};
+}
+
+#endif
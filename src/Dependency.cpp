@@ -24,8 +24,7 @@
 #include <boost/lexical_cast.hpp>
 #include "Dependency.hpp"
 #include "Gaggled.hpp"
-#include <set>
-#include <queue>
+#include "Event.hpp"
 
 gaggled::Dependency::Dependency(gaggled::Program* of, gaggled::Program* on, int delay, bool propagate) :
   of(of),
@@ -48,12 +47,16 @@ std::string gaggled::Dependency::to_string() {
   return r;
 }
 
-bool gaggled::Dependency::is_of(Program* p) {
-  return this->of == p;
+gaggled::Program* gaggled::Dependency::get_of() {
+  return this->of;
 }
 
-bool gaggled::Dependency::is_on(Program* p) {
-  return this->on == p;
+int gaggled::Dependency::get_delay() {
+  return this->delay;
+}
+
+gaggled::Program* gaggled::Dependency::get_on() {
+  return this->on;
 }
 
 void gaggled::Dependency::link(Gaggled* g) {
@@ -73,34 +76,8 @@ void gaggled::Dependency::link(Gaggled* g) {
     throw gaggled::BadConfigException("dependency on linkage failed: " + bce.reason);
   }
 
-  // check now via BFS if we can reach 'of' by following outbound dependencies from 'on'; this means that we'll be creating
-  // a dependency cycle which is not tolerable.
-  {
-    std::set<Program*> cs; // cycle set; the set that we should not find dependencies on
-    std::queue<Program*> q; // queue; the set of programs to check outbound dependencies from
-
-    cs.insert(of);
-    q.push(on);
-
-    while (not q.empty()) {
-      Program* n = q.front();
-      q.pop();
-
-      if (cs.find(n) != cs.end()) {
-        throw gaggled::BadConfigException(of->getName() + " cannot depend on " + on->getName() + " as this would create a dependency cycle.");
-      }
-
-      cs.insert(n);
-
-      auto outbound = n->get_dependencies();
-      for (auto o = outbound.begin(); o != outbound.end(); o++) {
-        q.push((*o)->on);
-      }
-    }
-  }
-
-  on->add_dependency(this);
-  of->add_dependency(this);
+  // the graph itself, and looking for cycles in it, happen once everything is linked.
+  // see Gaggled::parse_config().
 }
 
 bool gaggled::Dependency::satisfied() {
@@ -108,11 +85,21 @@ bool gaggled::Dependency::satisfied() {
   return this->on->is_up(this->delay);
 }
 
+void gaggled::Dependency::defer(Event* e) {
+  if (this->on->is_running()) {
+    // it's up, just not for long enough yet: come back exactly when it will have been.
+    e->defer_until(this->on->up_at(this->delay));
+  } else {
+    // nothing can change until it starts, which will requeue e.
+    this->on->park(e);
+  }
+}
+
 void gaggled::Dependency::prop_down(Gaggled* g) {
   if (this->propagate) {
     // this dependency has propagation turned on, so we should create a conditional restarting kill event.
     if (g->is_running())
-      new KillEvent(g, this->of, SIGTERM, true, false);
+      new KillEvent(g, this->of, true, false);
   }
 }
 
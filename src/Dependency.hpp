@@ -27,16 +27,19 @@
 namespace gaggled {
 class Program;
 class Gaggled;
+class Event;
 class Dependency
 {
 public:
   Dependency(std::string of, std::string on, int delay, bool propagate);
   Dependency(Program* of, Program* on, int delay, bool propagate);
   std::string to_string();
-  bool is_of(Program* p);
-  bool is_on(Program* p);
+  Program* get_of();
+  Program* get_on();
+  int get_delay();
   void link(Gaggled* g);
   bool satisfied();
+  void defer(Event* e);
   void prop_down(Gaggled* g);
 private:
   Program* of;
@@ -0,0 +1,68 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include "DependencyGraph.hpp"
+#include "Dependency.hpp"
+#include "Program.hpp"
+
+gaggled::DependencyGraph::DependencyGraph() {}
+
+void gaggled::DependencyGraph::build(std::vector<gaggled::Program*>& programs, std::vector<gaggled::Dependency*>& dependencies) {
+  const size_t n = programs.size();
+
+  // count edges per program, then turn the counts into starting offsets
+  out_offsets.assign(n + 1, 0);
+  in_offsets.assign(n + 1, 0);
+  for (auto d = dependencies.begin(); d != dependencies.end(); d++) {
+    out_offsets[(*d)->get_of()->get_index() + 1]++;
+    in_offsets[(*d)->get_on()->get_index() + 1]++;
+  }
+  for (size_t i = 0; i != n; i++) {
+    out_offsets[i + 1] += out_offsets[i];
+    in_offsets[i + 1] += in_offsets[i];
+  }
+
+  // place each edge; config order is kept within a program's edges
+  out_edges.assign(dependencies.size(), NULL);
+  in_edges.assign(dependencies.size(), NULL);
+  std::vector<size_t> out_fill(out_offsets.begin(), out_offsets.end() - 1);
+  std::vector<size_t> in_fill(in_offsets.begin(), in_offsets.end() - 1);
+  for (auto d = dependencies.begin(); d != dependencies.end(); d++) {
+    out_edges[out_fill[(*d)->get_of()->get_index()]++] = *d;
+    in_edges[in_fill[(*d)->get_on()->get_index()]++] = *d;
+  }
+}
+
+gaggled::Dependency** gaggled::DependencyGraph::outbound_begin(size_t program) {
+  return out_edges.data() + out_offsets[program];
+}
+
+gaggled::Dependency** gaggled::DependencyGraph::outbound_end(size_t program) {
+  return out_edges.data() + out_offsets[program + 1];
+}
+
+gaggled::Dependency** gaggled::DependencyGraph::inbound_begin(size_t program) {
+  return in_edges.data() + in_offsets[program];
+}
+
+gaggled::Dependency** gaggled::DependencyGraph::inbound_end(size_t program) {
+  return in_edges.data() + in_offsets[program + 1];
+}
@@ -0,0 +1,54 @@
+#ifndef GAGGLED_DEPENDENCYGRAPH_HPP_INCLUDED
+#define GAGGLED_DEPENDENCYGRAPH_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stddef.h>
+#include <vector>
+
+namespace gaggled {
+class Program;
+class Dependency;
+
+// the dependency graph, frozen after config load. outbound (of -> on, what a program
+// depends on) and inbound (on <- of, what depends on a program) edges are kept in
+// separate compressed sparse row arrays indexed by Program::get_index(), so walking
+// either direction touches only that program's own edges, contiguously.
+class DependencyGraph
+{
+public:
+  DependencyGraph();
+  void build(std::vector<Program*>& programs, std::vector<Dependency*>& dependencies);
+  Dependency** outbound_begin(size_t program);
+  Dependency** outbound_end(size_t program);
+  Dependency** inbound_begin(size_t program);
+  Dependency** inbound_end(size_t program);
+private:
+  // edges of program i are edges[offsets[i]] up to edges[offsets[i + 1]]
+  std::vector<size_t> out_offsets;
+  std::vector<Dependency*> out_edges;
+  std::vector<size_t> in_offsets;
+  std::vector<Dependency*> in_edges;
+};
+}
+
+#endif
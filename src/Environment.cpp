@@ -0,0 +1,62 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stdlib.h>
+#include <sysexits.h>
+#include "Environment.hpp"
+
+gaggled::Environment::Environment() {
+}
+
+gaggled::Environment::Environment(const std::map<std::string, std::string>& vars) {
+  // a map is already in name order.
+  entries.reserve(vars.size());
+  for (auto v = vars.begin(); v != vars.end(); v++)
+    entries.push_back(std::make_pair(v->first, v->first + "=" + v->second));
+}
+
+size_t gaggled::Environment::size() const {
+  return entries.size();
+}
+
+char** gaggled::Environment::overlay(const Environment& base, const Environment& own) {
+  char** envp = (char**) malloc(sizeof(char*) * (base.entries.size() + own.entries.size() + 1));
+  if (envp == NULL)
+    exit(EX_OSERR);
+
+  // merge the two in name order, own winning ties.
+  size_t n = 0;
+  auto b = base.entries.begin();
+  auto o = own.entries.begin();
+  while (b != base.entries.end() or o != own.entries.end()) {
+    if (o == own.entries.end() or (b != base.entries.end() and b->first < o->first)) {
+      envp[n++] = const_cast<char*>(b->second.c_str());
+      b++;
+    } else {
+      if (b != base.entries.end() and b->first == o->first)
+        b++;
+      envp[n++] = const_cast<char*>(o->second.c_str());
+      o++;
+    }
+  }
+  envp[n] = NULL;
+  return envp;
+}
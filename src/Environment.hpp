@@ -0,0 +1,50 @@
+#ifndef GAGGLED_ENVIRONMENT_HPP_INCLUDED
+#define GAGGLED_ENVIRONMENT_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stddef.h>
+#include <string>
+#include <map>
+#include <vector>
+
+namespace gaggled {
+
+// a set of environment variables, sorted by name and not changed once built. gaggled
+// keeps one for the environment every program shares and each program one for its own
+// additions, and only puts the two together when the program is started.
+class Environment
+{
+public:
+  Environment();
+  explicit Environment(const std::map<std::string, std::string>& vars);
+  size_t size() const;
+  // a NULL terminated envp of base with own's variables added, replacing any of base's
+  // with the same name. the strings stay base's and own's; only the array is free()d.
+  static char** overlay(const Environment& base, const Environment& own);
+private:
+  // name, and name=value ready to hand to exec
+  std::vector<std::pair<std::string, std::string> > entries;
+};
+}
+
+#endif
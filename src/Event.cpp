@@ -19,7 +19,6 @@
 
 // I N C L U D E S ###########################################################//
 
-#include <sys/time.h>
 #include <signal.h>
 #include <iostream>
 #include <ostream>
@@ -27,66 +26,96 @@
 #include "Event.hpp"
 #include "Dependency.hpp"
 #include "Program.hpp"
+#include "Clock.hpp"
 
 // B A S E   E V E N T ######################################################//
 
+uint64_t gaggled::Event::sequence = 0;
+gaggled::EventPool gaggled::Event::pool;
+
+static_assert(sizeof(gaggled::StartEvent) <= EVENT_SLOT_SIZE, "StartEvent does not fit in an EventPool slot");
+static_assert(sizeof(gaggled::KillEvent) <= EVENT_SLOT_SIZE, "KillEvent does not fit in an EventPool slot");
+static_assert(sizeof(gaggled::DiedEvent) <= EVENT_SLOT_SIZE, "DiedEvent does not fit in an EventPool slot");
+
+void* gaggled::Event::operator new(size_t size) {
+  return gaggled::Event::pool.alloc(size);
+}
+
+void gaggled::Event::operator delete(void* slot) {
+  gaggled::Event::pool.release(slot);
+}
+
 gaggled::Event::Event(gaggled::Gaggled* g, gaggled::Dependency* d, gaggled::Program* p, pid_t pid, int delay, int priority) :
   g(g),
   d(d),
   p(p),
   pid(pid),
-  priority(priority)
+  priority(priority),
+  cancelled(false),
+  parked_on(NULL),
+  pending_prev(NULL),
+  pending_next(NULL)
 {
+  if (p != NULL)
+    p->track(this);
   this->set_delay(delay);
   this->queue();
 }
 
+gaggled::Event::~Event() {
+  if (this->p != NULL and not this->cancelled)
+    this->p->untrack(this);
+}
+
 void gaggled::Event::set_delay(int delay) {
-  this->delay = delay;
-  if (delay != 0) {
-    // ### get the time of day first
-    // http://en.wikipedia.org/wiki/Year_2038_problem
-    if (gettimeofday(&(this->when), NULL) != 0)
-      std::cout << "error: failed to gettimeofday(), timing behaviour warning." << std::endl;
-
-    // ### convert the delay into sec and usec portions
-    // get sec portion
-    int delay_sec = delay / 1000;
-    // get only usec portion
-    int delay_usec = (delay - delay_sec * 1000) * 1000;
-
-    // ### update the when time structure to indicate the timeval when the event is valid to be handled
-    // apply seconds
-    this->when.tv_sec += delay_sec;
-    // cumulative (now + more) usec
-    delay_usec = this->when.tv_usec + delay_usec;
-    if (delay_usec >= 1000000) {
-      // carry
-      delay_usec -= 1000000;
-      this->when.tv_sec++;
-    }
-    // new value!
-    this->when.tv_usec = delay_usec;
-  }
+  this->set_deadline(gaggled::Clock::now() + (uint64_t) delay * NSEC_PER_MSEC);
+  this->delayed = (delay != 0);
+}
+
+void gaggled::Event::set_deadline(uint64_t when) {
+  this->delayed = true;
+  // break deadline ties in the order events were scheduled
+  this->seq = gaggled::Event::sequence++;
+  // the time at which the event is valid to be handled
+  this->when = when;
+}
+
+void gaggled::Event::defer_until(uint64_t when) {
+  this->set_deadline(when);
+  this->queue();
 }
 
 bool gaggled::Event::yet() {
-  if (this->delay == 0) {
+  if (not this->delayed)
     return true;
+  return gaggled::Clock::now() >= this->when;
+}
+
+bool gaggled::Event::due_before(gaggled::Event* other) {
+  if (this->when != other->when)
+    return this->when < other->when;
+  return this->seq < other->seq;
+}
+
+long gaggled::Event::usec_until() {
+  uint64_t now = gaggled::Clock::now();
+  if (not this->delayed or now >= this->when)
+    return 0;
+  // round up, waking a little late is fine but early means a wasted pass.
+  return (this->when - now + NSEC_PER_USEC - 1) / NSEC_PER_USEC;
+}
+
+void gaggled::Event::queue() {
+  // delayed events wait in the timer heap until they are due, ready ones go straight
+  // to their priority queue.
+  if (not this->delayed) {
+    this->g->event_queues[this->priority]->push(this);
   } else {
-    timeval tn;
-    if (gettimeofday(&tn, NULL) != 0)
-      std::cout << "error: failed to gettimeofday(), timing behaviour warning." << std::endl;
-    if (tn.tv_sec > this->when.tv_sec) {
-      return true;
-    } else if ((tn.tv_sec == this->when.tv_sec) && (tn.tv_usec >= this->when.tv_usec)) {
-      return true;
-    }
+    this->g->timers.push(this);
   }
-  return false;
 }
 
-void gaggled::Event::queue() {
+void gaggled::Event::ready() {
   this->g->event_queues[this->priority]->push(this);
 }
 
@@ -95,6 +124,25 @@ bool gaggled::Event::handle() {
   return true;
 }
 
+void gaggled::Event::cancel() {
+  // the event stays wherever it is queued and is deleted unhandled when it comes up;
+  // only the program's index forgets it now.
+  if (this->cancelled)
+    return;
+  this->cancelled = true;
+  if (this->p != NULL)
+    this->p->untrack(this);
+  // a parked event isn't in any queue that would come around to drop it.
+  if (this->parked_on != NULL) {
+    this->parked_on->unpark(this);
+    delete this;
+  }
+}
+
+bool gaggled::Event::is_cancelled() {
+  return this->cancelled;
+}
+
 gaggled::Program* gaggled::Event::get_program_pointer() {
   return p;
 }
@@ -112,19 +160,28 @@ std::ostream& gaggled::operator<< (std::ostream &stream, gaggled::Event& e) {
 // S T A R T   E V E N T #############################################//
 
 bool gaggled::StartEvent::handle() {
-  if (this->p->is_running())
-    return true;
-
-  if (this->p->is_operator_shutdown())
+  // a start let through by admission control that isn't going to happen gives its
+  // place back.
+  if (this->p->is_running() or this->p->is_spawning() or this->p->is_operator_shutdown()) {
+    this->g->admission.forfeit(this->p);
     return true;
+  }
   
-  if (not this->p->dependencies_satisfied()) {
-    this->set_delay(this->g->startwait);
-    this->queue();
+  // rather than retrying, wait on the first dependency that isn't satisfied: until the
+  // moment it will be if its program is up, or until its program starts if not.
+  gaggled::Dependency* blocker = this->p->unsatisfied_dependency();
+  if (blocker != NULL) {
+    this->g->admission.forfeit(this->p);
+    blocker->defer(this);
     return false;
   }
 
+  // held back if too many are starting already; admission requeues it later.
+  if (not this->g->admission.admit(this))
+    return false;
+
   this->p->start(this->g);
+  this->g->admission.started(this->p);
   return true;
 }
 
@@ -133,14 +190,28 @@ std::string gaggled::StartEvent::to_string() {
   return r;
 }
 
-gaggled::StartEvent::StartEvent(gaggled::Gaggled* g, gaggled::Program* p) :
-  gaggled::Event(g, NULL, p, 0, 0, QPRI_START) {}
+gaggled::StartEvent::StartEvent(gaggled::Gaggled* g, gaggled::Program* p, int delay) :
+  gaggled::Event(g, NULL, p, 0, delay, QPRI_START) {}
 
 // K I L L   E V E N T ###############################################//
 
 bool gaggled::KillEvent::handle() {
-  if (this->signal == SIGTERM) {
-    new KillEvent(this->g, this->p, SIGKILL, this->prop, this->token, g->killwait);
+  if (this->signal == 0) {
+    // the start of a stop: the first signal now, and every later one queued behind it,
+    // each acting only on the instance this one does. if SIGKILL is due sooner or later
+    // than configured (a deadline, or a learned killwait) every step moves in proportion.
+    const std::vector<StopStep>& steps = this->p->get_stop_steps();
+    int64_t last = steps.back().at;
+    int64_t wait = this->g->kill_wait(this->p);
+    for (size_t i = 1; i < steps.size(); i++) {
+      int64_t at = steps[i].at;
+      if (wait != last and last > 0)
+        at = at * wait / last;
+      new KillEvent(this->g, this->p, steps[i].signal, this->prop, this->token, (int) at);
+    }
+    this->signal = steps.front().signal;
+  } else if (this->signal == SIGKILL) {
+    this->g->overran(this->p, this->token);
   }
   this->p->kill_program(this->g, this->signal, this->prop, this->token);
   return true;
@@ -150,9 +221,9 @@ std::string gaggled::KillEvent::to_string() {
   return std::string("Kill Event");
 }
 
-gaggled::KillEvent::KillEvent(gaggled::Gaggled* g, gaggled::Program* p, int signal, bool prop, bool ignore_token) :
+gaggled::KillEvent::KillEvent(gaggled::Gaggled* g, gaggled::Program* p, bool prop, bool ignore_token) :
   gaggled::Event(g, NULL, p, 0, 0, QPRI_KILL),
-  signal(signal),
+  signal(0),
   prop(prop)
 {
   if (ignore_token) {
@@ -173,8 +244,17 @@ gaggled::KillEvent::KillEvent(gaggled::Gaggled* g, gaggled::Program* p, int sign
 // D I E D   E V E N T ###############################################//
 
 bool gaggled::DiedEvent::handle() {
-  if (this->g->pid_map.find(this->pid) == this->g->pid_map.end()) {
-    std::cout << "unknown child " << this->pid << " died. discarding.\n";
+  if (this->pid == this->g->spawner.get_pid()) {
+    this->g->spawner_died();
+  } else if (this->g->discarded_children.erase(this->pid) != 0) {
+    // never counted as up, so nothing to do.
+  } else if (this->g->pid_map.find(this->pid) == this->g->pid_map.end()) {
+    if (this->g->spawns_in_flight() != 0) {
+      // a spawned child can die before the spawner's reply about it is read.
+      this->g->unclaimed_deaths[this->pid] = std::make_pair(down_type, rcode);
+    } else {
+      std::cout << "unknown child " << this->pid << " died. discarding.\n";
+    }
   } else {
     this->g->pid_map[this->pid]->died(this->g, down_type, rcode);
   }
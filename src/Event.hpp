@@ -23,8 +23,9 @@
 // I N C L U D E S ###########################################################//
 
 #include <unistd.h>
-#include <time.h>
+#include <stdint.h>
 #include <ostream>
+#include "EventPool.hpp"
 #include "Program.hpp"
 #include "Dependency.hpp"
 #include "Gaggled.hpp"
@@ -35,10 +36,21 @@ class Dependency;
 class Program;
 class Event
 {
+  friend class Program;
 public:
   Event(Gaggled* g, Dependency* d, Program* p, pid_t pid, int delay, int priority);
+  virtual ~Event();
+  static void* operator new(size_t size);
+  static void operator delete(void* slot);
+  static EventPool pool;
   bool yet();
+  bool due_before(Event* other);
+  long usec_until();
   void queue();
+  void ready();
+  void defer_until(uint64_t when);
+  void cancel();
+  bool is_cancelled();
   virtual bool handle();
   virtual std::string to_string();
   virtual Program* get_program_pointer();
@@ -48,26 +60,37 @@ protected:
   Program* p;
   pid_t pid;
   void set_delay(int delay);
+  void set_deadline(uint64_t when);
 private:
-  int delay;
-  struct timeval when;
+  static uint64_t sequence;
+  bool delayed;
+  uint64_t when;
+  uint64_t seq;
   int priority;
+  bool cancelled;
+  // program this event is waiting to start, see Program::park()
+  Program* parked_on;
+  // links in p's list of pending events, see Program::track()
+  Event* pending_prev;
+  Event* pending_next;
 };
 
 class StartEvent : public Event {
 public: 
-  StartEvent(Gaggled* g, Program* p);
+  StartEvent(Gaggled* g, Program* p, int delay = 0);
   virtual bool handle();
   virtual std::string to_string();
 };
 
 class KillEvent : public Event {
 public: 
-  KillEvent(Gaggled* g, Program* p, int signal, bool prop, bool ignore_token);
+  // stops p the way it's configured to be stopped
+  KillEvent(Gaggled* g, Program* p, bool prop, bool ignore_token);
   KillEvent(Gaggled* g, Program* p, int signal, bool prop, unsigned long long token, int delay);
   virtual bool handle();
   virtual std::string to_string();
 private:
+  // 0 until a stop has sent its first signal
   int signal;
   bool prop;
   unsigned long long token;
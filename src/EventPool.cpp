@@ -0,0 +1,87 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stdlib.h>
+#include <new>
+#include "EventPool.hpp"
+
+gaggled::EventPool::EventPool() :
+  free_list(NULL),
+  n_live(0),
+  n_peak(0)
+{}
+
+gaggled::EventPool::~EventPool() {
+  for (auto s = slabs.begin(); s != slabs.end(); s++)
+    free(*s);
+}
+
+void gaggled::EventPool::grow() {
+  Slot* slab = (Slot*) malloc(sizeof(Slot) * EVENT_SLAB_SLOTS);
+  if (slab == NULL)
+    throw std::bad_alloc();
+  slabs.push_back(slab);
+
+  // thread the new slots onto the free list
+  for (int i = 0; i != EVENT_SLAB_SLOTS; i++) {
+    slab[i].next = free_list;
+    free_list = &(slab[i]);
+  }
+}
+
+void* gaggled::EventPool::alloc(size_t size) {
+  if (size > EVENT_SLOT_SIZE)
+    throw std::bad_alloc();
+
+  if (free_list == NULL)
+    grow();
+
+  Slot* s = free_list;
+  free_list = s->next;
+
+  n_live++;
+  if (n_live > n_peak)
+    n_peak = n_live;
+
+  return s;
+}
+
+void gaggled::EventPool::release(void* slot) {
+  if (slot == NULL)
+    return;
+
+  Slot* s = (Slot*) slot;
+  s->next = free_list;
+  free_list = s;
+  n_live--;
+}
+
+uint64_t gaggled::EventPool::live() {
+  return n_live;
+}
+
+uint64_t gaggled::EventPool::peak() {
+  return n_peak;
+}
+
+uint64_t gaggled::EventPool::capacity() {
+  return slabs.size() * EVENT_SLAB_SLOTS;
+}
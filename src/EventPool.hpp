@@ -0,0 +1,65 @@
+#ifndef GAGGLED_EVENTPOOL_HPP_INCLUDED
+#define GAGGLED_EVENTPOOL_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// every Event subclass must fit in a slot; Event.cpp checks this at compile time.
+#define EVENT_SLOT_SIZE 192
+#define EVENT_SLAB_SLOTS 256
+
+namespace gaggled {
+// fixed-size slab allocator backing Event's operator new/delete. slots are carved
+// out of slabs of EVENT_SLAB_SLOTS and recycled through a free list; slabs are
+// kept until the pool is destroyed, so a restart storm allocates once and then
+// reuses.
+class EventPool
+{
+public:
+  EventPool();
+  ~EventPool();
+  void* alloc(size_t size);
+  void release(void* slot);
+  uint64_t live();
+  uint64_t peak();
+  uint64_t capacity();
+private:
+  union Slot {
+    Slot* next;
+    // keep slots aligned for anything an event might hold
+    long double align_ld;
+    void* align_p;
+    uint64_t align_u;
+    unsigned char bytes[EVENT_SLOT_SIZE];
+  };
+  std::vector<Slot*> slabs;
+  Slot* free_list;
+  uint64_t n_live;
+  uint64_t n_peak;
+  void grow();
+};
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef GAGGLED_EXEC_FAILURE_HPP_INCLUDED
+#define GAGGLED_EXEC_FAILURE_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stdint.h>
+
+// why a child never got as far as running its program
+#define EXEC_FAIL_CHDIR 1
+#define EXEC_FAIL_PERM 2
+#define EXEC_FAIL_NOTFOUND 3
+#define EXEC_FAIL_BADBIN 4
+#define EXEC_FAIL_UNKNOWN 5
+#define EXEC_FAIL_STDIO 6
+#define EXEC_FAIL_CGROUP 7
+
+namespace gaggled {
+// written down a close-on-exec pipe by a child whose exec failed; a child that execs
+// writes nothing. reason is one of EXEC_FAIL_*, or 0 for none.
+struct ExecFailure {
+  int32_t reason;
+  int32_t err;
+};
+}
+
+#endif
@@ -21,7 +21,16 @@
 
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/resource.h>
+#ifdef __linux__
+#include <sys/signalfd.h>
+#include <sys/inotify.h>
+#endif
+#include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <time.h>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <queue>
@@ -30,14 +39,29 @@
 #include <boost/lexical_cast.hpp>
 #include "Event.hpp"
 #include "Gaggled.hpp"
+#include "Clock.hpp"
 #include "gaggled_control_server.hpp"
 #include "gaggled_events_server.hpp"
 
 gaggled::Gaggled::Gaggled(char* conf_file) :
   stopped(false),
+  report_requested(false),
   tick(10),
-  startwait(100),
-  killwait(10000)
+  killwait(10000),
+  stopsignal("SIGTERM"),
+  ordered_shutdown(false),
+  shutdowndeadline(0),
+  spawn("fork"),
+  spawnworkers(0),
+  backoff(Backoff::default_policy()),
+  churn(Backoff::default_churn()),
+  adaptive_kill(StopLatency::default_policy()),
+  coalesced_starts(0),
+  path_generation(0),
+  sigchld_fd(-1),
+  paths_fd(-1),
+  shutdown_began(0),
+  deadline_enforced(false)
 {
   for (int i = 0; i != QPRI_END; i++)
     this->event_queues[i] = new std::queue<Event*>();
@@ -54,14 +78,23 @@ gaggled::Gaggled::~Gaggled() {
 }
 
 void gaggled::Gaggled::clean_up() {
+  // workers hold programs; they have to be gone before the programs are.
+  this->pool.stop();
+  if (sigchld_fd != -1) {
+    close(sigchld_fd);
+    sigchld_fd = -1;
+  }
+  if (paths_fd != -1) {
+    close(paths_fd);
+    paths_fd = -1;
+  }
+  for (auto o = outputs.begin(); o != outputs.end(); o++)
+    close(o->first);
+  outputs.clear();
   if (path != NULL) {
     free(path);
     path = NULL;
   }
-  for (auto d = dependencies.begin(); d != dependencies.end(); d++)
-    delete *d;
-  for (auto p = programs.begin(); p != programs.end(); p++)
-    delete *p;
   for (int i = 0; i != QPRI_END; i++) {
     if (event_queues[i] == NULL)
       continue;
@@ -72,6 +105,18 @@ void gaggled::Gaggled::clean_up() {
     delete event_queues[i];
     event_queues[i] = NULL;
   }
+  while (not timers.empty()) {
+    delete timers.top();
+    timers.pop();
+  }
+  admission.clear();
+  for (auto p = programs.begin(); p != programs.end(); p++)
+    (*p)->release_parked(false);
+  // events unlink themselves from their programs, so programs go after them.
+  for (auto d = dependencies.begin(); d != dependencies.end(); d++)
+    delete *d;
+  for (auto p = programs.begin(); p != programs.end(); p++)
+    delete *p;
 }
 
 // TODO undo duplication here
@@ -81,6 +126,19 @@ void gaggled::Gaggled::write_state(gaggled_events_server::ProgramState& sc, Prog
   sc.dependencies_satisfied = (p->dependencies_satisfied() ? 1 : 0);
   sc.is_operator_shutdown = (p->is_operator_shutdown() ? 1 : 0);
   sc.state_sequence = p->state_changes() + 1;
+  sc.backoff_ms = p->get_backoff();
+  sc.churn_deaths = p->get_churn().deaths;
+  sc.churning = (p->is_churning() ? 1 : 0);
+  sc.stop_budget_ms = 0;
+  sc.stop_overran = 0;
+  if (not this->stop_budget.empty()) {
+    sc.stop_budget_ms = this->stop_budget[p->get_index()];
+    sc.stop_overran = (this->stop_overran[p->get_index()] ? 1 : 0);
+  }
+  sc.killwait_ms = p->kill_after();
+  sc.stop_samples = p->stop_samples();
+  sc.stop_p50_ms = p->stop_percentile(0.5);
+  sc.stop_p99_ms = p->stop_percentile(0.99);
   if (sc.up) {
     sc.during_shutdown = 0;
     sc.down_type = "NONE";
@@ -98,6 +156,19 @@ void gaggled::Gaggled::write_state(gaggled_control_server::ProgramState& sc, Pro
   sc.dependencies_satisfied = (p->dependencies_satisfied() ? 1 : 0);
   sc.is_operator_shutdown = (p->is_operator_shutdown() ? 1 : 0);
   sc.state_sequence = p->state_changes() + 1;
+  sc.backoff_ms = p->get_backoff();
+  sc.churn_deaths = p->get_churn().deaths;
+  sc.churning = (p->is_churning() ? 1 : 0);
+  sc.stop_budget_ms = 0;
+  sc.stop_overran = 0;
+  if (not this->stop_budget.empty()) {
+    sc.stop_budget_ms = this->stop_budget[p->get_index()];
+    sc.stop_overran = (this->stop_overran[p->get_index()] ? 1 : 0);
+  }
+  sc.killwait_ms = p->kill_after();
+  sc.stop_samples = p->stop_samples();
+  sc.stop_p50_ms = p->stop_percentile(0.5);
+  sc.stop_p99_ms = p->stop_percentile(0.99);
   if (sc.up) {
     sc.during_shutdown = 0;
     sc.down_type = "NONE";
@@ -175,16 +246,54 @@ void gaggled::Gaggled::parse_config(char* conf_file) {
     free(env_entry);
   }
 
+  // per program spawn overrides, applied once the gaggled section's default is known
+  std::map<Program*, std::string> program_spawn;
+  // likewise groups, and ready times that override the default from dependency delays
+  std::map<Program*, std::string> program_group;
+  std::map<Program*, int> program_ready;
+  // and the sections backoff and churn settings are read from, over the gaggled section's
+  std::map<Program*, boost::property_tree::ptree*> program_sections;
+
   for (auto iter = pt.begin(); iter != pt.end(); iter++) {
     std::string name = iter->first;
 
     if (name == "gaggled") {
       this->tick = iter->second.get<int>("tick", this->tick);
-      this->startwait = iter->second.get<int>("startwait", this->startwait);
       this->killwait = iter->second.get<int>("killwait", this->killwait);
+      this->stopsignal = iter->second.get<std::string>("stopsignal", this->stopsignal);
+      this->escalation = iter->second.get<std::string>("escalation", this->escalation);
+      read_stop(iter->second, "gaggled");
+      std::string shutdown = iter->second.get<std::string>("shutdown", "parallel");
+      if (shutdown == "ordered")
+        this->ordered_shutdown = true;
+      else if (shutdown != "parallel")
+        throw gaggled::BadConfigException("gaggled has unknown shutdown setting " + shutdown + ", expected parallel or ordered.");
+      this->shutdowndeadline = iter->second.get<int>("shutdowndeadline", this->shutdowndeadline);
+      if (this->shutdowndeadline < 0)
+        throw gaggled::BadConfigException("gaggled has a negative shutdowndeadline.");
+      this->cgroup = iter->second.get<std::string>("cgroup", this->cgroup);
+      this->spawn = iter->second.get<std::string>("spawn", this->spawn);
+      this->spawnworkers = iter->second.get<int>("spawnworkers", this->spawnworkers);
+      this->admission.set_global(iter->second.get<int>("maxstarting", 0), iter->second.get<double>("startrate", 0));
+      this->backoff = read_backoff(iter->second, this->backoff, "gaggled");
+      this->churn = read_churn(iter->second, this->churn, "gaggled");
+      this->adaptive_kill = read_adaptive_kill(iter->second, this->adaptive_kill, "gaggled");
+
+      boost::optional<boost::property_tree::ptree&> groups = iter->second.get_child_optional("groups");
+      if (groups) {
+        for (auto gr = groups->begin(); gr != groups->end(); gr++) {
+          if (this->admission.find_group(gr->first) != -1)
+            throw gaggled::BadConfigException(std::string("duplicate group name ") + gr->first);
+          this->admission.add_group(gr->first, gr->second.get<int>("maxstarting", 0), gr->second.get<double>("startrate", 0));
+        }
+      }
       this->eventurl = iter->second.get<std::string>("eventurl", this->eventurl);
       this->controlurl = iter->second.get<std::string>("controlurl", this->controlurl);
 
+      boost::optional<boost::property_tree::ptree&> env_o = iter->second.get_child_optional("env");
+      if (env_o)
+        read_env_config(*env_o, &env_map);
+
       std::string pre_path = iter->second.get<std::string>("path", "");
       if (pre_path != "") {
         if (path != NULL) {
@@ -232,6 +341,11 @@ void gaggled::Gaggled::parse_config(char* conf_file) {
 
       bool respawn = iter->second.get<bool>("respawn", true);
       bool enabled = iter->second.get<bool>("enabled", true);
+      std::string spawn = iter->second.get<std::string>("spawn", "");
+      std::string group = iter->second.get<std::string>("group", "");
+      boost::optional<int> ready = iter->second.get_optional<int>("ready");
+      std::string stdio_to[3] = {iter->second.get<std::string>("stdin", ""), iter->second.get<std::string>("stdout", ""), iter->second.get<std::string>("stderr", "")};
+      std::string pass_fds = iter->second.get<std::string>("passfds", "");
 
       // read program specific env
       std::map<std::string, std::string> own_env;
@@ -266,6 +380,17 @@ void gaggled::Gaggled::parse_config(char* conf_file) {
       Program* p = new Program(name, command, argv_vec, own_env, wd, respawn, enabled);
       this->programs.push_back(p);
       this->program_map[name] = p;
+      if (spawn != "")
+        program_spawn[p] = spawn;
+      if (group != "")
+        program_group[p] = group;
+      if (ready)
+        program_ready[p] = *ready;
+      for (int i = 0; i != 3; i++)
+        stdio_setting(p, i, stdio_to[i]);
+      if (pass_fds != "")
+        p->set_pass_fds(pass_fds_setting(pass_fds, name));
+      program_sections[p] = &(iter->second);
 
       boost::optional<boost::property_tree::ptree&> depends = iter->second.get_child_optional("depends");
       if (depends) {
@@ -293,17 +418,404 @@ void gaggled::Gaggled::parse_config(char* conf_file) {
     free(path_split);
   }
 
-  // overlay environments and do $PATH searches
+  if (this->cgroup != "") {
+    while (this->cgroup.size() > 1 and this->cgroup[this->cgroup.size() - 1] == '/')
+      this->cgroup.erase(this->cgroup.size() - 1);
+    if (access((this->cgroup + "/cgroup.procs").c_str(), F_OK) != 0)
+      throw gaggled::BadConfigException("gaggled cgroup " + this->cgroup + " is not a cgroup v2 directory.");
+  }
+
+  // the environment every program starts from, kept once for all of them
+  this->environment = Environment(env_map);
+
+  // hand out the environment and do $PATH searches
   for (auto p = this->programs.begin(); p != this->programs.end(); p++) {
-    (*p)->overlay_environment(env_map);
+    auto ps = program_spawn.find(*p);
+    if (ps != program_spawn.end())
+      (*p)->set_spawn_method(spawn_method(ps->second, (*p)->getName()));
+    else
+      (*p)->set_spawn_method(spawn_method(this->spawn, "gaggled"));
+
+    auto psec = program_sections.find(*p);
+    boost::property_tree::ptree none;
+    (*p)->set_stop_steps(read_stop(psec != program_sections.end() ? *(psec->second) : none, (*p)->getName()));
+    if (psec != program_sections.end()) {
+      (*p)->set_backoff(read_backoff(*(psec->second), this->backoff, (*p)->getName()));
+      (*p)->set_churn(read_churn(*(psec->second), this->churn, (*p)->getName()));
+      (*p)->set_adaptive_kill(read_adaptive_kill(*(psec->second), this->adaptive_kill, (*p)->getName()));
+      (*p)->set_process_group(psec->second->get<bool>("processgroup", true));
+      if (psec->second->get<bool>("cgroup", false)) {
+        if (this->cgroup == "")
+          throw gaggled::BadConfigException("program " + (*p)->getName() + " wants its own cgroup, but gaggled has no cgroup set.");
+        if ((*p)->getName() == "." or (*p)->getName() == ".." or (*p)->getName().find('/') != std::string::npos)
+          throw gaggled::BadConfigException("program " + (*p)->getName() + " can't have a cgroup named after it.");
+        (*p)->set_cgroup(this->cgroup + "/" + (*p)->getName());
+      }
+    } else {
+      (*p)->set_backoff(this->backoff);
+      (*p)->set_churn(this->churn);
+      (*p)->set_adaptive_kill(this->adaptive_kill);
+    }
+
+    (*p)->set_environment(&(this->environment));
     if (not (*p)->search(&(this->paths)) and not (*p)->is_operator_shutdown())
       throw gaggled::BadConfigException("program " + (*p)->get_command() + " not found, not a file, or not executable");
   }
 
   // link up the graph now that we have all programs loaded
+  for (size_t i = 0; i != this->programs.size(); i++)
+    this->programs[i]->set_index(i);
   for (auto d = this->dependencies.begin(); d != this->dependencies.end(); d++) {
     (*d)->link(this);
   }
+
+  // freeze it into the form all traversals use
+  this->graph.build(this->programs, this->dependencies);
+  for (auto p = this->programs.begin(); p != this->programs.end(); p++)
+    (*p)->set_graph(&(this->graph));
+
+  this->validate_graph();
+
+  for (auto pg = program_group.begin(); pg != program_group.end(); pg++) {
+    int group = this->admission.find_group(pg->second);
+    if (group == -1)
+      throw gaggled::BadConfigException("program " + pg->first->getName() + " is in group " + pg->second + ", which is not in gaggled.groups.");
+    pg->first->set_group(group);
+  }
+  this->rank_programs(program_ready);
+}
+
+int gaggled::Gaggled::spawn_method(const std::string& spawn, const std::string& section) {
+  if (spawn == "fork")
+    return SPAWN_FORK;
+  if (spawn == "posix_spawn")
+    return SPAWN_POSIX_SPAWN;
+  if (spawn == "spawner")
+    return SPAWN_SPAWNER;
+  throw gaggled::BadConfigException(section + " has unknown spawn setting " + spawn + ", expected fork, posix_spawn or spawner.");
+}
+
+int gaggled::Gaggled::signal_setting(const std::string& signal, const std::string& section) {
+  static const struct {
+    const char* name;
+    int signal;
+  } names[] = {
+    {"HUP", SIGHUP}, {"INT", SIGINT}, {"QUIT", SIGQUIT}, {"ABRT", SIGABRT}, {"KILL", SIGKILL},
+    {"USR1", SIGUSR1}, {"USR2", SIGUSR2}, {"PIPE", SIGPIPE}, {"ALRM", SIGALRM}, {"TERM", SIGTERM},
+    {"CONT", SIGCONT}, {"STOP", SIGSTOP}, {"TSTP", SIGTSTP}, {"WINCH", SIGWINCH}, {NULL, 0}
+  };
+  std::string name = boost::to_upper_copy(signal);
+  if (boost::starts_with(name, "SIG"))
+    name = name.substr(3);
+  for (int i = 0; names[i].name != NULL; i++)
+    if (name == names[i].name)
+      return names[i].signal;
+  try {
+    int number = boost::lexical_cast<int>(signal);
+    if (number > 0 and number < NSIG)
+      return number;
+  } catch (boost::bad_lexical_cast&) {
+  }
+  throw gaggled::BadConfigException(section + " has unknown signal " + signal + ".");
+}
+
+std::vector<gaggled::StopStep> gaggled::Gaggled::read_stop(boost::property_tree::ptree& pt, const std::string& section) {
+  int killwait = pt.get<int>("killwait", this->killwait);
+  // a section's own settings beat the gaggled section's, so a stopsignal of its own
+  // isn't overridden by an escalation it would otherwise have been given.
+  boost::optional<std::string> own_signal = pt.get_optional<std::string>("stopsignal");
+  boost::optional<std::string> own_escalation = pt.get_optional<std::string>("escalation");
+  std::string stopsignal = (own_signal ? *own_signal : this->stopsignal);
+  std::string escalation = (own_escalation ? *own_escalation : (own_signal ? "" : this->escalation));
+  if (killwait < 0)
+    throw gaggled::BadConfigException(section + " has a negative killwait.");
+
+  // without an escalation, it's the stop signal and SIGKILL killwait after.
+  std::vector<StopStep> steps;
+  if (escalation == "") {
+    StopStep first = {signal_setting(stopsignal, section), 0};
+    steps.push_back(first);
+  }
+
+  // otherwise signals at times from the first, like "SIGINT@0 SIGTERM@5s SIGKILL@15s".
+  std::vector<std::string> split;
+  boost::split(split, escalation, boost::is_any_of(" \t,"), boost::token_compress_on);
+  for (auto e = split.begin(); e != split.end(); e++) {
+    if (*e == "")
+      continue;
+    size_t at = e->find('@');
+    if (at == std::string::npos)
+      throw gaggled::BadConfigException(section + " has escalation step " + *e + ", expected signal@time.");
+    StopStep step;
+    step.signal = signal_setting(e->substr(0, at), section);
+    std::string when = e->substr(at + 1);
+    double scale = 1;
+    if (boost::ends_with(when, "ms")) {
+      when.erase(when.size() - 2);
+    } else if (boost::ends_with(when, "s")) {
+      when.erase(when.size() - 1);
+      scale = 1000;
+    }
+    try {
+      double ms = boost::lexical_cast<double>(when) * scale;
+      if (ms < 0 or ms > 2147483647)
+        throw boost::bad_lexical_cast();
+      step.at = (int) ms;
+    } catch (boost::bad_lexical_cast&) {
+      throw gaggled::BadConfigException(section + " has escalation step " + *e + ", whose time is not a number of ms or s.");
+    }
+    if (steps.empty() and step.at != 0)
+      throw gaggled::BadConfigException(section + " has an escalation that doesn't start at 0.");
+    if (not steps.empty() and step.at < steps.back().at)
+      throw gaggled::BadConfigException(section + " has escalation step " + *e + " before the one ahead of it.");
+    if (not steps.empty() and steps.back().signal == SIGKILL)
+      throw gaggled::BadConfigException(section + " has escalation step " + *e + " after SIGKILL.");
+    steps.push_back(step);
+  }
+
+  if (steps.empty())
+    throw gaggled::BadConfigException(section + " has an empty escalation.");
+
+  // both in one section is fine as long as they say the same thing.
+  if (own_signal and own_escalation and escalation != "" and signal_setting(stopsignal, section) != steps.front().signal)
+    throw gaggled::BadConfigException(section + " has stopsignal " + stopsignal + ", but its escalation starts with another signal.");
+
+  // it always ends with SIGKILL, killwait after the last signal if it isn't one.
+  if (steps.back().signal != SIGKILL) {
+    int64_t at = (int64_t) steps.back().at + killwait;
+    StopStep kill = {SIGKILL, (int) std::min(at, (int64_t) 2147483647)};
+    steps.push_back(kill);
+  }
+  return steps;
+}
+
+gaggled::BackoffPolicy gaggled::Gaggled::read_backoff(boost::property_tree::ptree& pt, const BackoffPolicy& defaults, const std::string& section) {
+  BackoffPolicy policy;
+  policy.initial = pt.get<int>("backoff", defaults.initial);
+  policy.multiplier = pt.get<double>("backoffmultiplier", defaults.multiplier);
+  policy.max = pt.get<int>("backoffmax", defaults.max);
+  policy.jitter = pt.get<double>("backoffjitter", defaults.jitter);
+  policy.stable = pt.get<int>("stableafter", defaults.stable);
+
+  if (policy.initial < 0 or policy.max < 0 or policy.stable < 0)
+    throw gaggled::BadConfigException(section + " has a negative backoff, backoffmax or stableafter.");
+  if (policy.multiplier < 1.0)
+    throw gaggled::BadConfigException(section + " has backoffmultiplier below 1.");
+  if (policy.jitter < 0.0 or policy.jitter > 1.0)
+    throw gaggled::BadConfigException(section + " has backoffjitter outside 0 to 1.");
+  if (policy.max < policy.initial)
+    policy.max = policy.initial;
+  return policy;
+}
+
+gaggled::ChurnPolicy gaggled::Gaggled::read_churn(boost::property_tree::ptree& pt, const ChurnPolicy& defaults, const std::string& section) {
+  ChurnPolicy churn;
+  churn.deaths = pt.get<int>("churndeaths", defaults.deaths);
+  churn.window = pt.get<int>("churnwindow", defaults.window);
+  churn.pause = pt.get<int>("churnpause", defaults.pause);
+
+  if (churn.deaths < 0 or churn.window < 0 or churn.pause < 0)
+    throw gaggled::BadConfigException(section + " has a negative churndeaths, churnwindow or churnpause.");
+  return churn;
+}
+
+gaggled::AdaptiveKillPolicy gaggled::Gaggled::read_adaptive_kill(boost::property_tree::ptree& pt, const AdaptiveKillPolicy& defaults, const std::string& section) {
+  AdaptiveKillPolicy policy;
+  policy.enabled = pt.get<bool>("adaptivekillwait", defaults.enabled);
+  policy.multiplier = pt.get<double>("killwaitmultiplier", defaults.multiplier);
+  policy.min = pt.get<int>("killwaitmin", defaults.min);
+  policy.max = pt.get<int>("killwaitmax", defaults.max);
+
+  if (policy.multiplier <= 0)
+    throw gaggled::BadConfigException(section + " has a killwaitmultiplier that isn't positive.");
+  if (policy.min < 0 or policy.max < 0)
+    throw gaggled::BadConfigException(section + " has a negative killwaitmin or killwaitmax.");
+  return policy;
+}
+
+void gaggled::Gaggled::stdio_setting(Program* p, int stream, const std::string& to) {
+  const char* names[3] = {"stdin", "stdout", "stderr"};
+  if (to == "" or to == "inherit") {
+    p->set_stdio(stream, "");
+    return;
+  }
+  if (to == "pipe" and stream == 0)
+    throw gaggled::BadConfigException("program " + p->getName() + " can't have stdin from a pipe.");
+  if (to == "stdout" and stream != 2)
+    throw gaggled::BadConfigException("program " + p->getName() + " can only send stderr to stdout, not " + names[stream] + ".");
+  p->set_stdio(stream, to);
+}
+
+std::vector<int> gaggled::Gaggled::pass_fds_setting(const std::string& fds, const std::string& section) {
+  std::vector<std::string> split;
+  boost::split(split, fds, boost::is_any_of(" \t,"), boost::token_compress_on);
+
+  std::vector<int> pass_fds;
+  for (auto f = split.begin(); f != split.end(); f++) {
+    if (*f == "")
+      continue;
+    int fd;
+    try {
+      fd = boost::lexical_cast<int>(*f);
+    } catch (boost::bad_lexical_cast&) {
+      throw gaggled::BadConfigException(section + " has passfds entry " + *f + ", which is not a number.");
+    }
+    if (fd < 3)
+      throw gaggled::BadConfigException(section + " passes fd " + *f + "; stdin, stdout and stderr are set with stdin, stdout and stderr.");
+    if (fcntl(fd, F_GETFD) == -1)
+      throw gaggled::BadConfigException(section + " passes fd " + *f + ", which gaggled doesn't have open.");
+    pass_fds.push_back(fd);
+  }
+
+  std::sort(pass_fds.begin(), pass_fds.end());
+  pass_fds.erase(std::unique(pass_fds.begin(), pass_fds.end()), pass_fds.end());
+  if (pass_fds.size() > PASSFDS_MAX)
+    throw gaggled::BadConfigException(section + " passes more than " + boost::lexical_cast<std::string>(PASSFDS_MAX) + " fds.");
+  return pass_fds;
+}
+
+void gaggled::Gaggled::rank_programs(std::map<Program*, int>& program_ready) {
+  // depth is the longest chain of dependencies under a program, so held back starts
+  // can go bottom up. the graph has no cycles by now, so peeling off programs whose
+  // dependencies are all ranked reaches every one.
+  const size_t n = this->programs.size();
+  std::vector<size_t> depth(n, 0);
+  std::vector<size_t> unranked(n);
+  std::vector<size_t> ranked;
+  for (size_t i = 0; i != n; i++) {
+    unranked[i] = this->graph.outbound_end(i) - this->graph.outbound_begin(i);
+    if (unranked[i] == 0)
+      ranked.push_back(i);
+  }
+  while (not ranked.empty()) {
+    size_t on = ranked.back();
+    ranked.pop_back();
+    gaggled::Dependency** end = this->graph.inbound_end(on);
+    for (gaggled::Dependency** d = this->graph.inbound_begin(on); d != end; d++) {
+      size_t of = (*d)->get_of()->get_index();
+      if (depth[on] + 1 > depth[of])
+        depth[of] = depth[on] + 1;
+      if (--unranked[of] == 0)
+        ranked.push_back(of);
+    }
+  }
+
+  for (size_t i = 0; i != n; i++)
+    this->programs[i]->set_depth(depth[i]);
+
+  // and the same from the other end for shutdown: the longest chain of dependents above
+  // a program, so programs nothing depends on are in wave 0.
+  this->stop_depth.assign(n, 0);
+  for (size_t i = 0; i != n; i++) {
+    unranked[i] = this->graph.inbound_end(i) - this->graph.inbound_begin(i);
+    if (unranked[i] == 0)
+      ranked.push_back(i);
+  }
+  while (not ranked.empty()) {
+    size_t of = ranked.back();
+    ranked.pop_back();
+    gaggled::Dependency** end = this->graph.outbound_end(of);
+    for (gaggled::Dependency** d = this->graph.outbound_begin(of); d != end; d++) {
+      size_t on = (*d)->get_on()->get_index();
+      if (this->stop_depth[of] + 1 > this->stop_depth[on])
+        this->stop_depth[on] = this->stop_depth[of] + 1;
+      if (--unranked[on] == 0)
+        ranked.push_back(on);
+    }
+  }
+
+  // unless it says otherwise, a program is ready when everything that depends on it
+  // would start.
+  for (auto d = this->dependencies.begin(); d != this->dependencies.end(); d++) {
+    Program* on = (*d)->get_on();
+    if ((*d)->get_delay() > on->get_ready())
+      on->set_ready((*d)->get_delay());
+  }
+  for (auto pr = program_ready.begin(); pr != program_ready.end(); pr++)
+    pr->first->set_ready(pr->second);
+}
+
+void gaggled::Gaggled::validate_graph() {
+  // one pass of Tarjan's strongly connected components over the of -> on edges. every
+  // component with more than one program, or a program depending on itself, is a cycle.
+  // iterative so that long dependency chains can't exhaust the stack.
+  const size_t n = this->programs.size();
+  const size_t unvisited = (size_t) -1;
+
+  std::vector<bool> self_loop(n, false);
+  for (auto d = this->dependencies.begin(); d != this->dependencies.end(); d++)
+    if ((*d)->get_of() == (*d)->get_on())
+      self_loop[(*d)->get_of()->get_index()] = true;
+
+  std::vector<size_t> order(n, unvisited);
+  std::vector<size_t> low(n, 0);
+  std::vector<bool> on_stack(n, false);
+  std::vector<size_t> stack;
+  // call stack of (program, next outbound edge to look at)
+  std::vector<std::pair<size_t, size_t> > frames;
+  size_t next_order = 0;
+  std::vector<std::string> cycles;
+
+  for (size_t root = 0; root != n; root++) {
+    if (order[root] != unvisited)
+      continue;
+
+    frames.push_back(std::make_pair(root, 0));
+    while (not frames.empty()) {
+      size_t v = frames.back().first;
+      size_t& edge = frames.back().second;
+
+      if (edge == 0 and order[v] == unvisited) {
+        order[v] = low[v] = next_order++;
+        stack.push_back(v);
+        on_stack[v] = true;
+      }
+
+      gaggled::Dependency** outbound = this->graph.outbound_begin(v);
+      if (outbound + edge != this->graph.outbound_end(v)) {
+        size_t w = outbound[edge++]->get_on()->get_index();
+        if (order[w] == unvisited) {
+          frames.push_back(std::make_pair(w, 0));
+        } else if (on_stack[w] and order[w] < low[v]) {
+          low[v] = order[w];
+        }
+        continue;
+      }
+
+      // all of v's edges are done; if v is the root of a component, pop it off.
+      if (low[v] == order[v]) {
+        std::vector<size_t> component;
+        size_t w;
+        do {
+          w = stack.back();
+          stack.pop_back();
+          on_stack[w] = false;
+          component.push_back(w);
+        } while (w != v);
+
+        if (component.size() > 1 or self_loop[v]) {
+          std::string cycle;
+          for (auto c = component.rbegin(); c != component.rend(); c++)
+            cycle += (cycle == "" ? "" : ", ") + this->programs[*c]->getName();
+          cycles.push_back(cycle);
+        }
+      }
+
+      frames.pop_back();
+      if (not frames.empty()) {
+        size_t parent = frames.back().first;
+        if (low[v] < low[parent])
+          low[parent] = low[v];
+      }
+    }
+  }
+
+  if (not cycles.empty()) {
+    std::string reason = "dependency cycles are not allowed, found " + boost::lexical_cast<std::string>(cycles.size()) + ":";
+    for (auto c = cycles.begin(); c != cycles.end(); c++)
+      reason += " [" + *c + "]";
+    throw gaggled::BadConfigException(reason);
+  }
 }
 
 gaggled::GaggledController::GaggledController(Gaggled* g, const char* url) :
@@ -368,40 +880,89 @@ std::vector<gaggled_control_server::ProgramState> gaggled::GaggledController::ha
   return states;
 }
 
+void gaggled::Gaggled::unlimit_core() {
+  // posix_spawn can't set rlimits for the child, so raise ours and let children
+  // inherit it. done here, once, before there are spawn workers to race over it.
+  bool wanted = false;
+  for (auto p = this->programs.begin(); p != this->programs.end(); p++)
+    wanted = wanted or (*p)->get_spawn_method() == SPAWN_POSIX_SPAWN;
+  if (not wanted)
+    return;
+
+  struct rlimit inf;
+  inf.rlim_cur = RLIM_INFINITY;
+  inf.rlim_max = RLIM_INFINITY;
+  if (setrlimit(RLIMIT_CORE, &inf) == 0)
+    return;
+
+  // a forked child at least gets as much as its hard limit allows, as it always has.
+  std::cout << "warning: setrlimit(RLIMIT_CORE) failed, errno=" << errno << ", forking programs instead of using posix_spawn." << std::endl;
+  for (auto p = this->programs.begin(); p != this->programs.end(); p++)
+    if ((*p)->get_spawn_method() == SPAWN_POSIX_SPAWN)
+      (*p)->set_spawn_method(SPAWN_FORK);
+}
+
 void gaggled::Gaggled::run() {
   eventserver = NULL;
   controlserver = NULL;
 
+  // before any children exist, arrange to be told when they die. this comes before
+  // the zmq sockets so their threads start with SIGCHLD blocked too, and the spawner
+  // is forked before there are any threads at all.
+  this->watch_children();
+  this->watch_paths();
+  this->unlimit_core();
+  this->start_spawner();
+  if (this->spawnworkers > 0)
+    this->pool.start(this->spawnworkers, &(this->reactor));
+
   if (controlurl != "") {
     controlserver = new GaggledController(this, controlurl.c_str());
+    this->watch_control();
   }
   if (eventurl != "") {
     eventserver = new gaggled_events_server::gaggled_events(eventurl.c_str());
   }
 
+  gaggled::Clock::update();
+
   // kick off start of enabled processes
   for (auto p = this->programs.begin(); p != this->programs.end(); p++)
     if (!(*p)->is_operator_shutdown())
-      new gaggled::StartEvent(this, *p);
+      (*p)->request_start(this);
 
   bool known_stopped = false;
   std::cout << "[gaggled] running. tick=" << this->tick << ", controlurl=" << this->controlurl << ", eventurl=" << this->eventurl << ", PATH=" << this->path << std::endl << std::flush;
-  while ((not this->stopped) or (this->pid_map.begin() != this->pid_map.end())) {
+  while ((not this->stopped) or (this->pid_map.begin() != this->pid_map.end()) or (this->spawns_in_flight() != 0)) {
     // check if this is the first event loop run that is in the shutdown mode
     // we have to kick off the creation of the kill events, as we couldn't do that in the signal handler
     // that called stop() - this could lock.
-    if (known_stopped != this->stopped) {
-      std::cout << "[gaggled] caught signal, shutting down." << std::endl << std::flush;
-      for (auto p = this->programs.begin(); p != this->programs.end(); p++)
-        new KillEvent(this, *p, SIGTERM, false, true);
-    }
+    if (known_stopped != this->stopped)
+      this->begin_shutdown();
+    if (this->stopped)
+      this->enforce_deadline();
 
     // and now we know..
     known_stopped = this->stopped;
 
+    if (this->report_requested) {
+      this->report_requested = false;
+      this->report();
+    }
+
     // first, check if any child processes have died.
     this->check_deaths();
 
+    // move every delayed event whose deadline has passed into its priority queue.
+    // events that are not yet due stay in the timer heap and are not looked at.
+    while (not this->timers.empty() and this->timers.top()->yet()) {
+      this->timers.top()->ready();
+      this->timers.pop();
+    }
+
+    // and every held back start that admission control lets go of now.
+    this->admission.release();
+
     // don't loop forever in each loop. We need to get back to the other queue, or starvation could result.
     // if currently processed keep creating new events in the current queue, this will result in issues.
     // so instead of using the queues directly, we move all presently queued objects into the now_queue and use that queue
@@ -429,49 +990,449 @@ void gaggled::Gaggled::run() {
         e = now_queue.front();
         now_queue.pop();
 
-        if (not e->yet()) {
-          // re-queue events that are not yet runnable
-          e->queue();
-        } else {
-          // if an event returns true, it is done with and should be deleted
-          if (e->handle()) {
-            // e has dealt with itself, but cannot delete itself. delete!
-            delete e;
-            processed++;
-          }
+        // cancelled events are just dropped
+        if (e->is_cancelled()) {
+          delete e;
+          continue;
+        }
+
+        // if an event returns true, it is done with and should be deleted
+        if (e->handle()) {
+          // e has dealt with itself, but cannot delete itself. delete!
+          delete e;
+          processed++;
         }
       }
     }
 
-    // events are processed, now nap a little if we did nothing this time;
-    // otherwise, get right back into it!
-    if (controlserver == NULL) {
-      if (processed == 0) {
-        usleep(1000 * this->tick);
+    // events are processed, now sleep until something happens if we did nothing this
+    // time; otherwise, just pick up anything already waiting and get right back into it!
+    // something happening is a death, a control request, stop() or the next delayed
+    // event coming due.  where deaths can't wake us we still have to poll every tick.
+    long nap = -1;
+    if (processed == 0) {
+      if (not this->timers.empty())
+        nap = this->timers.top()->usec_until();
+      long held = this->admission.usec_until_release();
+      if (not this->stopped and held >= 0 and (nap < 0 or held < nap))
+        nap = held;
+      if (this->stopped and not this->deadline_enforced and this->shutdowndeadline > 0) {
+        uint64_t now = gaggled::Clock::now();
+        long until = (now < this->shutdown_deadline() ? (this->shutdown_deadline() - now) / NSEC_PER_USEC : 0);
+        if (nap < 0 or until < nap)
+          nap = until;
       }
+      if (this->sigchld_fd == -1 and (nap < 0 or nap > 1000 * this->tick))
+        nap = 1000 * this->tick;
     } else {
-      try {
-        if (processed == 0) {
-          controlserver->run_once(1000 * this->tick);
-        } else {
-          controlserver->run_once(0);
-        }
-      } catch (gaggled_control_server::BadMessage& gcs_bm) {
-        std::cout << "[gaggled] got an bad incoming message on control channel, discarding." << std::endl << std::flush;
-      }
+      nap = 0;
     }
+
+    int woken = this->reactor.wait(nap);
+    // the one clock reading for the next pass, taken before control requests so they
+    // report current uptimes.
+    gaggled::Clock::update();
+    if (woken & REACTOR_WAKE_CONTROL)
+      this->service_control();
+    // a search directory changed, so every cached executable path has to be looked up
+    // again at its next start. without a watch we can't know, so always look again.
+    if ((woken & REACTOR_WAKE_PATHS) or not this->reactor.watching_paths())
+      this->path_generation++;
+    if (woken & REACTOR_WAKE_SPAWNER)
+      this->collect_spawns();
+    if (woken & REACTOR_WAKE_OUTPUT)
+      this->drain_outputs();
+    this->collect_pool();
   }
 
+  // whatever the last programs wrote on their way out.
+  this->drain_outputs();
+
+  // every program is down and what it left was killed as it died, so its cgroup can go,
+  // unless something in it is still on its way out.
+  for (auto p = this->programs.begin(); p != this->programs.end(); p++)
+    if ((*p)->get_cgroup() != "")
+      rmdir((*p)->get_cgroup().c_str());
+
+  if (this->shutdown_began != 0)
+    std::cout << "[gaggled] shut down in " << (gaggled::Clock::update() - this->shutdown_began) / NSEC_PER_MSEC << "ms." << std::endl << std::flush;
+
+  this->report();
+
   if (eventserver != NULL)
     delete eventserver;
   if (controlserver != NULL)
     delete controlserver;
 }
 
+void gaggled::Gaggled::begin_shutdown() {
+  this->shutdown_began = gaggled::Clock::update();
+  this->stop_budget.assign(this->programs.size(), 0);
+  this->stop_overran.assign(this->programs.size(), false);
+  if (not this->ordered_shutdown) {
+    std::cout << "[gaggled] caught signal, shutting down." << std::endl << std::flush;
+    for (auto p = this->programs.begin(); p != this->programs.end(); p++)
+      new KillEvent(this, *p, false, true);
+    return;
+  }
+
+  // a program is stopped once everything up that depends on it has exited, so the
+  // leaves go first and each program follows as soon as its last dependent is gone,
+  // without waiting on the rest of its wave.
+  std::cout << "[gaggled] caught signal, shutting down in dependency order." << std::endl << std::flush;
+  const size_t n = this->programs.size();
+  this->stop_blockers.assign(n, 0);
+  this->stop_holding.assign(n, false);
+  this->stop_released.assign(n, false);
+  for (size_t i = 0; i != n; i++)
+    this->stop_holding[i] = this->programs[i]->is_running() or this->programs[i]->is_spawning();
+  for (auto d = this->dependencies.begin(); d != this->dependencies.end(); d++)
+    if (this->stop_holding[(*d)->get_of()->get_index()])
+      this->stop_blockers[(*d)->get_on()->get_index()]++;
+  for (size_t i = 0; i != n; i++)
+    if (this->stop_blockers[i] == 0)
+      this->release_stop(i);
+}
+
+void gaggled::Gaggled::release_stop(size_t program) {
+  this->stop_released[program] = true;
+  // one that's already down has nothing to stop, and never held anything up.
+  if (not this->stop_holding[program])
+    return;
+  Program* p = this->programs[program];
+  std::cout << "[gaggled] stopping " << p->getName() << ", wave " << this->stop_depth[program] << ", " << (gaggled::Clock::now() - this->shutdown_began) / NSEC_PER_MSEC << "ms into shutdown." << std::endl << std::flush;
+  new KillEvent(this, p, false, true);
+}
+
+void gaggled::Gaggled::program_down(Program* p) {
+  if (this->shutdown_began == 0 or not this->ordered_shutdown)
+    return;
+  size_t i = p->get_index();
+  if (not this->stop_holding[i] or p->is_running() or p->is_spawning())
+    return;
+  this->stop_holding[i] = false;
+  gaggled::Dependency** end = this->graph.outbound_end(i);
+  for (gaggled::Dependency** d = this->graph.outbound_begin(i); d != end; d++) {
+    size_t on = (*d)->get_on()->get_index();
+    if (--this->stop_blockers[on] == 0 and not this->stop_released[on])
+      this->release_stop(on);
+  }
+}
+
+bool gaggled::Gaggled::may_stop(Program* p) {
+  // until shutdown has begun, whether it will have to wait isn't known; it's counted
+  // as up then.
+  if (not this->ordered_shutdown)
+    return true;
+  return this->shutdown_began != 0 and this->stop_released[p->get_index()];
+}
+
+int gaggled::Gaggled::kill_wait(Program* p) {
+  if (this->shutdown_began == 0)
+    return p->kill_after();
+
+  // what's left of the deadline is shared between this program and the longest chain
+  // of programs that can only be stopped after it, so that even if every one of them
+  // needs its SIGKILL the last is down in time. without dependency order they all go
+  // at once and each can have all of it.
+  int wait = p->kill_after();
+  if (this->shutdowndeadline > 0) {
+    uint64_t now = gaggled::Clock::now();
+    uint64_t left = (now < this->shutdown_deadline() ? (this->shutdown_deadline() - now) / NSEC_PER_MSEC : 0);
+    uint64_t waves = (this->ordered_shutdown ? p->get_depth() + 1 : 1);
+    if (left / waves < (uint64_t) wait)
+      wait = left / waves;
+  }
+  if (p->is_running() or p->is_spawning())
+    this->stop_budget[p->get_index()] = wait;
+  return wait;
+}
+
+void gaggled::Gaggled::overran(Program* p, unsigned long long token) {
+  if (this->shutdown_began == 0 or not p->is_running())
+    return;
+  if (token != 0 and token != p->get_token())
+    return;
+  size_t i = p->get_index();
+  this->stop_overran[i] = true;
+  std::cout << "[gaggled] " << p->getName() << ": still up after its " << this->stop_budget[i] << "ms to stop, overran." << std::endl << std::flush;
+  this->broadcast_state(p);
+}
+
+uint64_t gaggled::Gaggled::shutdown_deadline() {
+  // less a little for SIGKILLs sent right at it to be delivered and reaped.
+  uint64_t reserve = std::min(SHUTDOWN_KILL_RESERVE, this->shutdowndeadline / 10);
+  return this->shutdown_began + (this->shutdowndeadline - reserve) * NSEC_PER_MSEC;
+}
+
+void gaggled::Gaggled::enforce_deadline() {
+  if (this->shutdowndeadline == 0 or this->deadline_enforced or this->shutdown_began == 0)
+    return;
+  if (gaggled::Clock::now() < this->shutdown_deadline())
+    return;
+  // everything released in time was given a SIGKILL by now. whatever is still waiting
+  // on a dependent that couldn't be stopped (one still being spawned, or stuck in the
+  // kernel) goes now, and at once.
+  this->deadline_enforced = true;
+  if (not this->ordered_shutdown)
+    return;
+  for (size_t i = 0; i != this->programs.size(); i++) {
+    if (not this->stop_released[i] and this->stop_holding[i]) {
+      std::cout << "[gaggled] shutdowndeadline reached, not waiting on what depends on " << this->programs[i]->getName() << "." << std::endl << std::flush;
+      this->release_stop(i);
+    }
+  }
+}
+
+void gaggled::Gaggled::capture_output(Program* p, int fd) {
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  this->outputs[fd].name = p->getName();
+  this->reactor.watch_output(fd);
+}
+
+void gaggled::Gaggled::drain_outputs() {
+  char buf[4096];
+  for (auto o = this->outputs.begin(); o != this->outputs.end(); ) {
+    CapturedOutput& out = o->second;
+    // a bounded read per pass, so one chatty program can't hold up the loop; whatever
+    // is left wakes us again straight away.
+    ssize_t got = -1;
+    for (int reads = 0; reads != 16; reads++) {
+      got = read(o->first, buf, sizeof(buf));
+      if (got <= 0)
+        break;
+      out.partial.append(buf, got);
+
+      size_t from = 0;
+      size_t nl;
+      while ((nl = out.partial.find('\n', from)) != std::string::npos) {
+        std::cout << "[" << out.name << "] " << out.partial.substr(from, nl - from) << "\n";
+        from = nl + 1;
+      }
+      out.partial.erase(0, from);
+      // a program that never ends its lines still gets heard.
+      if (out.partial.size() >= sizeof(buf)) {
+        std::cout << "[" << out.name << "] " << out.partial << "\n";
+        out.partial.clear();
+      }
+    }
+
+    // every writer is gone, or it broke: finish off the last line and forget it.
+    if (got == 0 or (got == -1 and errno != EAGAIN and errno != EWOULDBLOCK and errno != EINTR)) {
+      if (out.partial != "")
+        std::cout << "[" << out.name << "] " << out.partial << "\n";
+      this->reactor.unwatch_output(o->first);
+      close(o->first);
+      this->outputs.erase(o++);
+    } else {
+      o++;
+    }
+  }
+  std::cout << std::flush;
+}
+
+void gaggled::Gaggled::report() {
+  std::cout << "[gaggled] events: live=" << gaggled::Event::pool.live() << " peak=" << gaggled::Event::pool.peak() << " pooled=" << gaggled::Event::pool.capacity() << " delayed=" << this->timers.size() << " coalesced_starts=" << this->coalesced_starts << " held_starts=" << this->admission.held_count() << std::endl;
+  for (auto p = this->programs.begin(); p != this->programs.end(); p++) {
+    std::vector<gaggled::Event*> pending = (*p)->pending_events();
+    if (pending.empty())
+      continue;
+    std::cout << "[gaggled] pending for " << (*p)->getName() << ":";
+    for (auto e = pending.begin(); e != pending.end(); e++)
+      std::cout << " " << (**e) << " (" << (*e)->usec_until() / 1000 << "ms)";
+    std::cout << std::endl;
+  }
+  std::cout << std::flush;
+}
+
+void gaggled::Gaggled::watch_children() {
+#ifdef __linux__
+  // SIGCHLD is blocked and delivered through a signalfd instead, so that a death can
+  // wake the reactor and check_deaths() only calls waitid() when something died.
+  // children get the old mask back in Program::start() before exec.
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGCHLD);
+  if (sigprocmask(SIG_BLOCK, &mask, NULL) != 0) {
+    std::cout << "warning: failed to block SIGCHLD, polling for child deaths." << std::endl;
+    return;
+  }
+  sigchld_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (sigchld_fd == -1) {
+    std::cout << "warning: signalfd() failed, errno=" << errno << ", polling for child deaths." << std::endl;
+    sigprocmask(SIG_UNBLOCK, &mask, NULL);
+  } else {
+    this->reactor.watch_children(sigchld_fd);
+  }
+#endif
+}
+
+void gaggled::Gaggled::watch_paths() {
+#ifdef __linux__
+  // watch every directory a command could be found in, so Program::start() can exec
+  // the path it resolved last time until one of them gains, loses or chmods an entry.
+  paths_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (paths_fd == -1) {
+    std::cout << "warning: inotify_init1() failed, errno=" << errno << ", searching for commands on every start." << std::endl;
+    return;
+  }
+
+  std::set<std::string> dirs;
+  for (auto p = this->programs.begin(); p != this->programs.end(); p++)
+    (*p)->search_dirs(&dirs);
+
+  uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF;
+  for (auto d = dirs.begin(); d != dirs.end(); d++) {
+    // a $PATH entry that doesn't exist can't hold a command now, and if it is created
+    // later it won't be searched until gaggled restarts.
+    if (inotify_add_watch(paths_fd, d->c_str(), mask) == -1 and errno != ENOENT and errno != ENOTDIR)
+      std::cout << "warning: cannot watch " << *d << " for changes, errno=" << errno << std::endl;
+  }
+
+  this->reactor.watch_paths(paths_fd);
+#endif
+}
+
+void gaggled::Gaggled::start_spawner() {
+  bool wanted = false;
+  for (auto p = this->programs.begin(); p != this->programs.end(); p++)
+    if ((*p)->get_spawn_method() == SPAWN_SPAWNER)
+      wanted = true;
+
+  // if it doesn't start, those programs are forked directly instead.
+  if (wanted and this->spawner.start(&(this->programs)))
+    this->reactor.watch_spawner(this->spawner.get_fd());
+}
+
+void gaggled::Gaggled::collect_spawns() {
+  SpawnReply reply;
+  while (this->spawner.read_reply(&reply)) {
+    if (reply.index < this->programs.size())
+      this->spawn_done(this->programs[reply.index], reply.pid, reply.failure);
+  }
+
+  if (this->spawner.is_hung_up())
+    this->spawner_died();
+
+  this->forget_unclaimed();
+}
+
+void gaggled::Gaggled::collect_pool() {
+  SpawnJob* j = this->pool.take_completed();
+  if (j == NULL)
+    return;
+
+  while (j != NULL) {
+    this->spawn_done(j->p, j->pid, j->failure);
+    SpawnJob* next = j->next;
+    delete j;
+    j = next;
+  }
+
+  this->forget_unclaimed();
+}
+
+void gaggled::Gaggled::spawn_done(Program* p, pid_t pid, const ExecFailure& failure) {
+  p->spawned(this, pid, failure);
+
+  // it may already have died before we knew it was ours.
+  if (pid == -1 or p->get_pid() != pid)
+    return;
+  auto u = this->unclaimed_deaths.find(pid);
+  if (u != this->unclaimed_deaths.end()) {
+    new gaggled::DiedEvent(this, pid, u->second.first, u->second.second);
+    this->unclaimed_deaths.erase(u);
+  }
+}
+
+size_t gaggled::Gaggled::spawns_in_flight() {
+  return this->spawner.in_flight() + this->pool.in_flight();
+}
+
+void gaggled::Gaggled::forget_unclaimed() {
+  // with nothing in flight, whatever is left really was no child of any program.
+  if (this->spawns_in_flight() != 0)
+    return;
+  for (auto u = this->unclaimed_deaths.begin(); u != this->unclaimed_deaths.end(); u++)
+    std::cout << "unknown child " << u->first << " died. discarding." << std::endl;
+  this->unclaimed_deaths.clear();
+}
+
+void gaggled::Gaggled::discard_child(pid_t pid) {
+  // reap it quietly whenever it goes, which may already have happened.
+  auto u = this->unclaimed_deaths.find(pid);
+  if (u != this->unclaimed_deaths.end())
+    this->unclaimed_deaths.erase(u);
+  else
+    this->discarded_children.insert(pid);
+}
+
+void gaggled::Gaggled::spawner_died() {
+  if (not this->spawner.is_running())
+    return;
+
+  std::cout << "[gaggled] spawner exited, spawning directly." << std::endl;
+  this->spawner.close_helper();
+  // requests it never answered are started again; a child it forked without telling
+  // us is lost to us.
+  for (auto p = this->programs.begin(); p != this->programs.end(); p++)
+    if ((*p)->is_spawning())
+      (*p)->spawn_lost(this);
+}
+
+void gaggled::Gaggled::watch_control() {
+  // the ZMQ_FD of a socket only says "look at ZMQ_EVENTS", it does not mean a request
+  // is waiting; service_control() sorts that out.
+  int fd = -1;
+  size_t fd_size = sizeof(fd);
+  try {
+    controlserver->sock->getsockopt(ZMQ_FD, &fd, &fd_size);
+  } catch (zmq::error_t& ze) {
+    std::cout << "error: could not get control socket fd, control requests will not be handled." << std::endl;
+    return;
+  }
+  this->reactor.watch_control(fd);
+  // requests may have arrived between bind and now without toggling the fd.
+  this->service_control();
+}
+
+void gaggled::Gaggled::service_control() {
+  while (true) {
+    uint32_t events = 0;
+    size_t events_size = sizeof(events);
+    try {
+      controlserver->sock->getsockopt(ZMQ_EVENTS, &events, &events_size);
+    } catch (zmq::error_t& ze) {
+      return;
+    }
+    if (not (events & ZMQ_POLLIN))
+      return;
+
+    try {
+      controlserver->run_once_bare();
+    } catch (gaggled_control_server::BadMessage& gcs_bm) {
+      std::cout << "[gaggled] got an bad incoming message on control channel, discarding." << std::endl << std::flush;
+    }
+  }
+}
+
 void gaggled::Gaggled::check_deaths() {
   int callstatus = 0;
   siginfo_t siginfo;
 
+#ifdef __linux__
+  if (sigchld_fd != -1) {
+    // SIGCHLDs coalesce, so the count means nothing beyond "at least one child
+    // changed state"; drain them all and then reap everything waitid() has for us.
+    struct signalfd_siginfo fdsi;
+    bool signalled = false;
+    while (read(sigchld_fd, &fdsi, sizeof(fdsi)) == sizeof(fdsi))
+      signalled = true;
+    if (not signalled)
+      return;
+  }
+#endif
+
   while (callstatus == 0) {
     siginfo.si_pid = 0;
     callstatus = waitid(P_ALL, 0, &siginfo, WNOHANG|WEXITED);
@@ -504,33 +1465,19 @@ void gaggled::Gaggled::check_deaths() {
 }
 
 void gaggled::Gaggled::stop() {
+  // called from signal handlers, keep this async-signal-safe.
   this->stopped = true;
+  this->reactor.wake();
 }
 
-bool gaggled::Gaggled::is_running() {
-  return not this->stopped;
+void gaggled::Gaggled::request_report() {
+  // called from signal handlers; the loop does the actual reporting.
+  this->report_requested = true;
+  this->reactor.wake();
 }
 
-void gaggled::Gaggled::flush_starts(gaggled::Program* p) {
-  for (int i = 0; i != QPRI_END; i++) {
-    if (event_queues[i] == NULL)
-      continue;
-    
-    std::queue<gaggled::Event*>* new_queue = new std::queue<gaggled::Event*>();
-    while (not event_queues[i]->empty()) {
-      gaggled::Event* ev = event_queues[i]->front();
-      event_queues[i]->pop();
-      if (dynamic_cast<gaggled::StartEvent*>(ev) == NULL) {
-        new_queue->push(ev);
-      } else if (ev->get_program_pointer() != p) {
-        new_queue->push(ev);
-      } else {
-        delete ev;
-      }
-    }
-    delete event_queues[i];
-    event_queues[i] = new_queue;
-  }
+bool gaggled::Gaggled::is_running() {
+  return not this->stopped;
 }
 
 gaggled::Program* gaggled::Gaggled::get_program(std::string name) {
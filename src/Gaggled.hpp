@@ -22,12 +22,22 @@
 #include <unistd.h>
 #include <vector>
 #include <map>
+#include <set>
 #include <queue>
 #include <stdexcept>
 
 #include "Program.hpp"
 #include "Dependency.hpp"
 #include "Event.hpp"
+#include "TimerHeap.hpp"
+#include "Reactor.hpp"
+#include "DependencyGraph.hpp"
+#include "Spawner.hpp"
+#include "SpawnPool.hpp"
+#include "Admission.hpp"
+#include "Backoff.hpp"
+#include "Environment.hpp"
+#include "StopPolicy.hpp"
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -45,6 +55,9 @@
 #define QPRI_THRESH_SHUTDOWN 2
 #define QPRI_END 3
 
+// the end of a shutdown deadline kept back for the last SIGKILLs to land, in ms
+#define SHUTDOWN_KILL_RESERVE 100
+
 #ifndef GAGGLED_HPP_INCLUDED
 #define GAGGLED_HPP_INCLUDED
 
@@ -62,6 +75,12 @@ class Event;
 class Program;
 class Dependency;
 class GaggledController;
+// a pipe a program's stdout or stderr is read from, and what's come out of it since
+// the last full line
+struct CapturedOutput {
+  std::string name;
+  std::string partial;
+};
 class Gaggled
 {
   friend class Program;
@@ -76,32 +95,111 @@ public:
   void run();
   void check_deaths();
   void stop();
+  void request_report();
   bool is_running();
-  void flush_starts(Program* p);
   Program* get_program(std::string name);
 private:
   gaggled_events_server::gaggled_events* eventserver;
   GaggledController* controlserver;
   bool stopped;
+  volatile bool report_requested;
   char* path;
   std::vector<std::string> paths;
+  Environment environment;
   int tick;
-  int startwait;
   int killwait;
+  // how programs are stopped, unless they say otherwise
+  std::string stopsignal;
+  std::string escalation;
+  // stop dependents before what they depend on, rather than everything at once
+  bool ordered_shutdown;
+  // milliseconds everything has to be down within once told to stop, 0 for no limit
+  int shutdowndeadline;
+  // a cgroup v2 directory programs can have their own cgroups made under
+  std::string cgroup;
+  std::string spawn;
+  int spawnworkers;
+  // respawn backoff for programs that don't set their own
+  BackoffPolicy backoff;
+  ChurnPolicy churn;
+  AdaptiveKillPolicy adaptive_kill;
   std::string eventurl;
   std::string controlurl;
   std::map<std::string, Program*> program_map;
   std::map<pid_t, Program*> pid_map;
   std::vector<Program*> programs;
   std::vector<Dependency*> dependencies;
+  DependencyGraph graph;
   std::queue<Event*>* event_queues[QPRI_END];
+  TimerHeap timers;
+  uint64_t coalesced_starts;
+  uint64_t path_generation;
+  Reactor reactor;
+  int sigchld_fd;
+  int paths_fd;
+  Spawner spawner;
+  SpawnPool pool;
+  Admission admission;
+  // deaths of children the spawner hasn't told us about yet
+  std::map<pid_t, std::pair<std::string, int> > unclaimed_deaths;
+  // spawned children whose exec failed, reaped without telling anyone
+  std::set<pid_t> discarded_children;
+  // by the fd gaggled reads them from; they outlive the child if its children hold them
+  std::map<int, CapturedOutput> outputs;
+  // when shutdown began, 0 until then
+  uint64_t shutdown_began;
+  // by program index: how many programs below the leaves a program is, how many of the
+  // programs depending on it still have to exit before it's stopped, whether it still
+  // holds up what it depends on, and whether it has been stopped
+  std::vector<size_t> stop_depth;
+  std::vector<size_t> stop_blockers;
+  std::vector<bool> stop_holding;
+  std::vector<bool> stop_released;
+  // and under a deadline, how long each was given before SIGKILL and whether it needed it
+  std::vector<uint64_t> stop_budget;
+  std::vector<bool> stop_overran;
+  bool deadline_enforced;
   void write_state(gaggled_events_server::ProgramState& sc, Program* p);
   void write_state(gaggled_control_server::ProgramState& sc, Program* p);
   void broadcast_state(Program* p);
   void read_env_config(boost::property_tree::ptree& pt, std::map<std::string, std::string>* write_to);
   std::string zmq_url_hostname_insert(const std::string& url, const std::string& hostname);
   void parse_config(char* conf_file);
+  int spawn_method(const std::string& spawn, const std::string& section);
+  BackoffPolicy read_backoff(boost::property_tree::ptree& pt, const BackoffPolicy& defaults, const std::string& section);
+  std::vector<StopStep> read_stop(boost::property_tree::ptree& pt, const std::string& section);
+  int signal_setting(const std::string& signal, const std::string& section);
+  ChurnPolicy read_churn(boost::property_tree::ptree& pt, const ChurnPolicy& defaults, const std::string& section);
+  AdaptiveKillPolicy read_adaptive_kill(boost::property_tree::ptree& pt, const AdaptiveKillPolicy& defaults, const std::string& section);
+  void validate_graph();
+  void rank_programs(std::map<Program*, int>& program_ready);
   void clean_up();
+  void watch_children();
+  void watch_paths();
+  void unlimit_core();
+  void start_spawner();
+  void collect_spawns();
+  void spawner_died();
+  void collect_pool();
+  void spawn_done(Program* p, pid_t pid, const ExecFailure& failure);
+  size_t spawns_in_flight();
+  void forget_unclaimed();
+  void discard_child(pid_t pid);
+  void begin_shutdown();
+  void release_stop(size_t program);
+  void program_down(Program* p);
+  bool may_stop(Program* p);
+  int kill_wait(Program* p);
+  void overran(Program* p, unsigned long long token);
+  uint64_t shutdown_deadline();
+  void enforce_deadline();
+  void capture_output(Program* p, int fd);
+  void drain_outputs();
+  void stdio_setting(Program* p, int stream, const std::string& to);
+  std::vector<int> pass_fds_setting(const std::string& fds, const std::string& section);
+  void watch_control();
+  void service_control();
+  void report();
 };
 
 class GaggledController : public gaggled_control_server::gaggled_control<GaggledController> {
@@ -20,42 +20,225 @@
 // I N C L U D E S ###########################################################//
 
 #include <unistd.h>
+#include <stdio.h>
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
-#include <sys/time.h>
 #include <sys/resource.h>
+#include <sys/wait.h>
+#include <fcntl.h>
 #include <sysexits.h>
 #include <signal.h>
+#include <errno.h>
+#include <spawn.h>
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2, 29)
+#define GAGGLED_HAVE_SPAWN_CHDIR
+#endif
+#if __GLIBC_PREREQ(2, 34)
+#define GAGGLED_HAVE_SPAWN_CLOSEFROM
+#endif
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <dirent.h>
+#endif
 #include <iostream>
 #include <string>
 #include <vector>
 #include <boost/lexical_cast.hpp>
 #include "Program.hpp"
 #include "Dependency.hpp"
+#include "DependencyGraph.hpp"
+#include "Event.hpp"
+#include "Clock.hpp"
 
 #define PTOK_INVAL 1
 unsigned long long gaggled::Program::instance_token = PTOK_INVAL + 1;
 
+// what a program runs with until gaggled gives it the shared environment
+static const gaggled::Environment no_environment;
+
+// pidfds let us signal exactly the child we forked even if its pid has been reaped and
+// recycled.  glibc did not wrap these for a long time, so go through syscall() and
+// report ENOSYS where the kernel or headers don't know about them.
+static int gaggled_pidfd_open(pid_t pid) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+  return syscall(SYS_pidfd_open, pid, 0);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+static int gaggled_pidfd_send_signal(int pidfd, int signal) {
+#if defined(__linux__) && defined(SYS_pidfd_send_signal)
+  return syscall(SYS_pidfd_send_signal, pidfd, signal, NULL, 0);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+static int gaggled_close_range(unsigned int first, unsigned int last) {
+#if defined(__linux__) && defined(SYS_close_range)
+  return syscall(SYS_close_range, first, last, 0);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+// where a forked child redirects stderr to wherever its stdout went
+#define STDIO_AS_STDOUT -2
+
+// the fds a child keeps besides its stdio: the ones passed to it and the pipe it reports
+// a failed exec down. kept needs room for PASSFDS_MAX + 1 and comes back sorted.
+static size_t kept_fds(const std::vector<int>& pass_fds, int report_fd, int* kept) {
+  size_t n = 0;
+  for (auto f = pass_fds.begin(); f != pass_fds.end(); f++)
+    kept[n++] = *f;
+  if (report_fd > 2) {
+    size_t i = n++;
+    for (; i > 0 and kept[i - 1] > report_fd; i--)
+      kept[i] = kept[i - 1];
+    kept[i] = report_fd;
+  }
+  return n;
+}
+
+static bool is_kept(int fd, const int* kept, size_t n_kept) {
+  for (size_t i = 0; i != n_kept; i++)
+    if (kept[i] == fd)
+      return true;
+  return false;
+}
+
+// close every fd from 3 up that isn't kept. only async-signal-safe calls, as it runs
+// between fork and exec and gaggled may have other threads.
+static void close_inherited_fds(const int* kept, size_t n_kept) {
+  // one close_range() per gap, however high the fd limit is.
+  unsigned int first = 3;
+  bool closed = true;
+  for (size_t i = 0; closed and i != n_kept; i++) {
+    if ((unsigned int) kept[i] > first)
+      closed = (gaggled_close_range(first, kept[i] - 1) == 0);
+    first = kept[i] + 1;
+  }
+  if (closed and gaggled_close_range(first, ~0U) == 0)
+    return;
+
+#ifdef __linux__
+  // otherwise just the fds that are open, as /proc lists them. closing them changes the
+  // listing under us, so go round again until a pass finds nothing left to close.
+  int dir = open("/proc/self/fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dir != -1) {
+    uint64_t buf[512];
+    closed = true;
+    while (closed) {
+      closed = false;
+      lseek(dir, 0, SEEK_SET);
+      long got;
+      while ((got = syscall(SYS_getdents64, dir, buf, sizeof(buf))) > 0) {
+        for (long off = 0; off < got; ) {
+          struct dirent64* d = (struct dirent64*) (void*) ((char*) buf + off);
+          off += d->d_reclen;
+          if (d->d_name[0] < '0' or d->d_name[0] > '9')
+            continue;
+          int fd = 0;
+          for (const char* c = d->d_name; *c != 0; c++)
+            fd = fd * 10 + (*c - '0');
+          if (fd < 3 or fd == dir or is_kept(fd, kept, n_kept))
+            continue;
+          close(fd);
+          closed = true;
+        }
+      }
+    }
+    close(dir);
+    return;
+  }
+#endif
+
+  // last resort: everything there could be.
+  long max = sysconf(_SC_OPEN_MAX);
+  for (long fd = 3; fd < max; fd++)
+    if (not is_kept(fd, kept, n_kept))
+      close(fd);
+}
+
+// a pipe or file opened for a child's stdio can't land on 0, 1 or 2 if gaggled was run
+// with them closed, or dup2()ing them into place would clobber one another.
+static int above_stdio(int fd) {
+  if (fd == -1 or fd > 2)
+    return fd;
+  int moved = fcntl(fd, F_DUPFD_CLOEXEC, 3);
+  close(fd);
+  return moved;
+}
+
+// moves the calling process into the cgroup whose cgroup.procs is at procs. only
+// async-signal-safe calls, as it runs in the child between fork and exec.
+static bool join_cgroup(const char* procs) {
+  int fd = open(procs, O_WRONLY | O_CLOEXEC);
+  if (fd == -1)
+    return false;
+  bool joined = (write(fd, "0", 1) == 1);
+  int err = errno;
+  close(fd);
+  errno = err;
+  return joined;
+}
+
 gaggled::Program::Program(std::string name, std::string command, std::vector<std::string>* argv, std::map<std::string, std::string> own_env, std::string wd, bool respawn, bool enabled) :
   name(name),
+  index(0),
   command(command),
+  resolved_generation(0),
   argv(argv),
   wd(wd),
+  environment(&no_environment),
   own_env(own_env),
+  process_group(true),
+  graph(NULL),
+  spawn_method(SPAWN_FORK),
+  depth(0),
+  ready(0),
+  group(-1),
   respawn(respawn),
   operator_shutdown(!enabled),
   controlled_shutdown(false),
   running(false),
+  spawning(false),
+  deferred_signal(0),
+  deferred_prop_start(false),
+  backoff_wait(0),
+  churning(false),
+  admission(ADMIT_NONE),
   prop_start(false),
   pid(0),
+  pidfd(-1),
+  stop_sent(0),
+  stop_killed(0),
+  output_r(-1),
+  output_w(-1),
+  started(0),
   token(PTOK_INVAL),
-  statechanges(0)
+  statechanges(0),
+  pending(NULL)
 {
+  this->churn = gaggled::Backoff::default_churn();
+  this->adaptive_kill = gaggled::StopLatency::default_policy();
+  StopStep term = {SIGTERM, 0};
+  StopStep kill = {SIGKILL, 10000};
+  this->stop_steps.push_back(term);
+  this->stop_steps.push_back(kill);
+  for (int i = 0; i != 3; i++)
+    this->child_stdio[i] = -1;
+
   if (argv == NULL) {
     this->argv = new std::vector<std::string>();
   }
-  dependencies = new std::vector<Dependency*>();
 
   if (argv) {
     if(!(exec_argv = (char**) malloc (sizeof(char*) * (argv->size() + 2))))
@@ -77,22 +260,15 @@ gaggled::Program::Program(std::string name, std::string command, std::vector<std
     // terminate ARGV with a NULL ptr
     exec_argv[this->argv->size()+1] = NULL;
   }
-
-  // create a null environment to start
-  exec_env = (char**) malloc (sizeof(char*));
-  exec_env[0] = NULL;
 }
 
 gaggled::Program::~Program() {
   for (int i = 0; exec_argv[i] != NULL; i++)
     free(exec_argv[i]);
-  for (int i = 0; exec_env[i] != NULL; i++)
-    free(exec_env[i]);
   free(exec_argv);
-  free(exec_env);
+  if (output_r != -1)
+    close(output_r);
 
-  // just the vector, not the dependencies themselves
-  delete dependencies;
   delete argv;
 }
 
@@ -110,45 +286,180 @@ bool gaggled::Program::search(std::vector<std::string>* path) {
     }
   }
 
+  return this->resolve();
+}
+
+bool gaggled::Program::resolve() {
+  resolved.clear();
+
   //buffer for storing stat() results
   struct stat st_buf;
-  // check if at least one is executable and a file...
+  // the first one that is executable and a file is what execve would have run
   for (auto c = commands.begin(); c != commands.end(); c++) {
     const char* fn = c->c_str();
     if (access(fn, X_OK) != 0)
       continue;
     // ensure that it's a regular file, not a directory
-    stat(fn, &st_buf);
-    if (S_ISREG(st_buf.st_mode))
+    if (stat(fn, &st_buf) == 0 and S_ISREG(st_buf.st_mode)) {
+      resolved.push_back(*c);
       return true;
+    }
   }
   return false;
 }
 
-void gaggled::Program::overlay_environment(std::map<std::string, std::string> global_environment) {
-  // overlay own over env from gaggled and global env{} block
-  for (auto own = own_env.begin(); own != own_env.end(); own++)
-    global_environment[own->first] = own->second;
+std::string gaggled::Program::resolved_path() {
+  if (resolved.empty())
+    return "";
+  return resolved[0];
+}
 
-  // delete the old env char**
-  free(exec_env);
+const std::vector<std::string>& gaggled::Program::exec_candidates() {
+  // with nothing resolved, try them all so the failure is classified as before
+  if (resolved.empty())
+    return commands;
+  return resolved;
+}
 
-  // create a new c style one...
-  exec_env = (char**) malloc (sizeof(char*) * (global_environment.size() + 1));
-  if (exec_env == NULL)
-    exit(EX_OSERR);
+void gaggled::Program::search_dirs(std::set<std::string>* dirs) {
+  for (auto c = commands.begin(); c != commands.end(); c++) {
+    size_t slash = c->rfind('/');
+    if (slash == 0)
+      dirs->insert("/");
+    else if (slash != std::string::npos)
+      dirs->insert(c->substr(0, slash));
+  }
+}
 
-  int i = 0;
-  for (auto en = global_environment.begin(); en != global_environment.end(); en++) {
-    std::string entry = en->first + "=" + en->second;
-    char* cpv = strdup(entry.c_str());
-    if (cpv == NULL)
-      exit(EX_OSERR);
-    exec_env[i++] = cpv;
+void gaggled::Program::set_environment(const Environment* environment) {
+  this->environment = environment;
+}
+
+void gaggled::Program::set_stdio(int stream, const std::string& to) {
+  this->stdio[stream] = to;
+}
+
+bool gaggled::Program::redirects_stdio() {
+  return this->stdio[0] != "" or this->stdio[1] != "" or this->stdio[2] != "";
+}
+
+void gaggled::Program::set_pass_fds(const std::vector<int>& fds) {
+  this->pass_fds = fds;
+}
+
+void gaggled::Program::set_process_group(bool process_group) {
+  this->process_group = process_group;
+}
+
+void gaggled::Program::set_stop_steps(const std::vector<StopStep>& steps) {
+  this->stop_steps = steps;
+}
+
+const std::vector<gaggled::StopStep>& gaggled::Program::get_stop_steps() {
+  return this->stop_steps;
+}
+
+void gaggled::Program::set_adaptive_kill(const AdaptiveKillPolicy& policy) {
+  this->adaptive_kill = policy;
+}
+
+int gaggled::Program::kill_after() {
+  return this->stop_latency.killwait(this->adaptive_kill, this->stop_steps.back().at);
+}
+
+uint64_t gaggled::Program::stop_percentile(double q) {
+  return this->stop_latency.percentile(q);
+}
+
+size_t gaggled::Program::stop_samples() {
+  return this->stop_latency.samples();
+}
+
+void gaggled::Program::set_cgroup(const std::string& cgroup) {
+  this->cgroup = cgroup;
+  this->cgroup_procs = (cgroup == "" ? "" : cgroup + "/cgroup.procs");
+}
+
+std::string gaggled::Program::get_cgroup() {
+  return this->cgroup;
+}
+
+bool gaggled::Program::open_stdio(ExecFailure* failure) {
+  for (int i = 0; i != 3; i++) {
+    const std::string& to = this->stdio[i];
+    if (to == "") {
+      continue;
+    } else if (to == "stdout") {
+      this->child_stdio[i] = STDIO_AS_STDOUT;
+    } else if (to == "pipe") {
+      // stdout and stderr share the one pipe.
+      if (this->output_w == -1) {
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) == 0) {
+          this->output_r = above_stdio(fds[0]);
+          this->output_w = above_stdio(fds[1]);
+        }
+      }
+      if (this->output_r == -1 or this->output_w == -1) {
+        failure->reason = EXEC_FAIL_STDIO;
+        failure->err = errno;
+        this->close_stdio(false);
+        return false;
+      }
+      this->child_stdio[i] = this->output_w;
+    } else {
+      int flags = (i == 0 ? O_RDONLY : O_WRONLY | O_CREAT | O_APPEND);
+      int fd = above_stdio(open(to == "null" ? "/dev/null" : to.c_str(), flags | O_CLOEXEC, 0644));
+      if (fd == -1) {
+        failure->reason = EXEC_FAIL_STDIO;
+        failure->err = errno;
+        std::cout << "failed to open \"" << to << "\" for " << name << ", errno=" << errno << std::endl;
+        this->close_stdio(false);
+        return false;
+      }
+      this->child_stdio[i] = fd;
+    }
+  }
+  return true;
+}
+
+void gaggled::Program::close_stdio(bool launched) {
+  // the child has its own copies by now.
+  for (int i = 0; i != 3; i++) {
+    if (this->child_stdio[i] >= 0 and this->child_stdio[i] != this->output_w)
+      close(this->child_stdio[i]);
+    this->child_stdio[i] = -1;
   }
-  exec_env[global_environment.size()] = NULL;
+  if (this->output_w != -1) {
+    close(this->output_w);
+    this->output_w = -1;
+  }
+  // nothing will ever write to a pipe for a child that didn't start.
+  if (not launched and this->output_r != -1) {
+    close(this->output_r);
+    this->output_r = -1;
+  }
+}
 
-  own_env = global_environment; //now that we've overlaid it... save it.
+char** gaggled::Program::environment_block() {
+  return gaggled::Environment::overlay(*(this->environment), this->own_env);
+}
+
+char** gaggled::Program::candidate_block(const std::string& path) {
+  // what exec_child() tries: a known path is all there is to try, otherwise search as
+  // at load time. made before forking, since the child mustn't allocate; it points into
+  // path or commands, so only the block is freed.
+  size_t n = (path == "" ? commands.size() : 1);
+  char** candidates = (char**) malloc(sizeof(char*) * (n + 1));
+  if (candidates == NULL)
+    exit(EX_OSERR);
+  if (path != "")
+    candidates[0] = const_cast<char*>(path.c_str());
+  else
+    for (size_t i = 0; i != n; i++)
+      candidates[i] = const_cast<char*>(commands[i].c_str());
+  candidates[n] = NULL;
+  return candidates;
 }
 
 std::string gaggled::Program::to_string() {
@@ -165,8 +476,78 @@ std::string gaggled::Program::getName() {
   return this->name;
 }
 
-void gaggled::Program::add_dependency(Dependency* d) {
-  this->dependencies->push_back(d);
+size_t gaggled::Program::get_index() {
+  return this->index;
+}
+
+void gaggled::Program::set_index(size_t index) {
+  this->index = index;
+}
+
+void gaggled::Program::set_spawn_method(int spawn_method) {
+  this->spawn_method = spawn_method;
+}
+
+int gaggled::Program::get_spawn_method() {
+  return this->spawn_method;
+}
+
+size_t gaggled::Program::get_depth() {
+  return this->depth;
+}
+
+void gaggled::Program::set_depth(size_t depth) {
+  this->depth = depth;
+}
+
+int gaggled::Program::get_ready() {
+  return this->ready;
+}
+
+void gaggled::Program::set_ready(int ready) {
+  this->ready = ready;
+}
+
+int gaggled::Program::get_group() {
+  return this->group;
+}
+
+void gaggled::Program::set_group(int group) {
+  this->group = group;
+}
+
+int gaggled::Program::get_admission() {
+  return this->admission;
+}
+
+void gaggled::Program::set_admission(int admission) {
+  this->admission = admission;
+}
+
+void gaggled::Program::set_backoff(const BackoffPolicy& policy) {
+  this->backoff.set_policy(policy);
+}
+
+int gaggled::Program::get_backoff() {
+  if (not this->running)
+    return this->backoff_wait;
+  return this->backoff.current(this->uptime());
+}
+
+void gaggled::Program::set_churn(const ChurnPolicy& policy) {
+  this->churn = policy;
+}
+
+const gaggled::ChurnPolicy& gaggled::Program::get_churn() {
+  return this->churn;
+}
+
+bool gaggled::Program::is_churning() {
+  return this->churning;
+}
+
+void gaggled::Program::set_graph(DependencyGraph* graph) {
+  this->graph = graph;
 }
 
 bool gaggled::Program::is_running() {
@@ -190,12 +571,74 @@ std::string gaggled::Program::get_command() {
 }
 
 bool gaggled::Program::dependencies_satisfied() {
-  for (auto i = this->dependencies->begin(); i != this->dependencies->end(); i++) {
-    if ((*i)->is_of(this) and not (*i)->satisfied()) {
-      return false;
+  return this->unsatisfied_dependency() == NULL;
+}
+
+gaggled::Dependency* gaggled::Program::unsatisfied_dependency() {
+  gaggled::Dependency** end = this->graph->outbound_end(this->index);
+  for (gaggled::Dependency** i = this->graph->outbound_begin(this->index); i != end; i++) {
+    if (not (*i)->satisfied()) {
+      return *i;
     }
   }
-  return true;
+  return NULL;
+}
+
+// sort a failed execve() of path into the categories we report, the way glibc execvpe does.
+static void classify_exec_error(int err, const char* path, bool* err_perm, bool* err_badbin, bool* notfound) {
+  *notfound = false;
+  switch (err) {
+    case EACCES:
+      // execve sets EACCESS when the file is not a regular file,
+      // but this really should be counted as no binary found instead
+      struct stat st_buf;
+      if (stat(path, &st_buf) == 0 and S_ISREG(st_buf.st_mode)) {
+        *err_perm = true;
+      } else {
+        *notfound = true;
+      }
+      break;
+    case ENOENT:
+    case ESTALE:
+    case ENOTDIR:
+    case ETIMEDOUT:
+    case ENODEV:
+      *notfound = true;
+      break;
+    case ENOEXEC:
+      *err_badbin = true;
+      break;
+  }
+}
+
+static int exec_failure_reason_code(bool err_perm, bool err_neverfound, bool err_badbin) {
+  if (err_perm) {
+    return EXEC_FAIL_PERM;
+  } else if (err_neverfound) {
+    return EXEC_FAIL_NOTFOUND;
+  } else if (err_badbin) {
+    return EXEC_FAIL_BADBIN;
+  } else {
+    return EXEC_FAIL_UNKNOWN;
+  }
+}
+
+static const char* exec_failure_reason(int reason) {
+  switch (reason) {
+    case EXEC_FAIL_CGROUP:
+      return " could not be put in its cgroup.";
+    case EXEC_FAIL_STDIO:
+      return " could not open its stdin, stdout or stderr.";
+    case EXEC_FAIL_CHDIR:
+      return " could not change to its working directory.";
+    case EXEC_FAIL_PERM:
+      return " was not executable due to permissions.";
+    case EXEC_FAIL_BADBIN:
+      return " executable format bad.";
+    case EXEC_FAIL_NOTFOUND:
+      return " file not found.";
+  }
+  return " could not execute for an unknown reason.";
 }
 
 void gaggled::Program::start(Gaggled* g) {
@@ -203,101 +646,376 @@ void gaggled::Program::start(Gaggled* g) {
     std::cout << "not starting " << name << ", gaggled is shutting down." << std::endl << std::flush;
   }
 
+  // its cgroup is made on first use and kept for every start after.
+  if (this->cgroup != "" and mkdir(this->cgroup.c_str(), 0755) != 0 and errno != EEXIST) {
+    ExecFailure failure;
+    failure.reason = EXEC_FAIL_CGROUP;
+    failure.err = errno;
+    std::cout << "failed to create cgroup " << this->cgroup << " for " << name << ", errno=" << errno << std::endl;
+    this->exec_failed(g, failure);
+    return;
+  }
+
+  // look the command up again only if a directory it could be in has changed since.
+  if (this->resolved.empty() or this->resolved_generation != g->path_generation) {
+    this->resolve();
+    this->resolved_generation = g->path_generation;
+  }
+
+  // the helper does the fork and exec and we pick the child up in spawned(). if it
+  // can't take the request, do it ourselves.
+  // the spawner can't hand a child the files it should have as its stdio.
+  if (this->spawn_method == SPAWN_SPAWNER and not this->redirects_stdio() and g->spawner.request(this, this->resolved_path())) {
+    this->spawning = true;
+    this->deferred_signal = 0;
+    return;
+  }
+
+  // or a spawn worker does it and we pick the child up in spawned() just the same.
+  if (this->spawn_method != SPAWN_SPAWNER and g->pool.submit(this)) {
+    this->spawning = true;
+    this->deferred_signal = 0;
+    return;
+  }
+
+  // both report a failed exec before returning, so a program that can't run is never up.
+  ExecFailure failure;
+  pid_t pid = this->spawn(&failure, true);
+
+  if (failure.reason != 0)
+    this->exec_failed(g, failure);
+  else if (pid != -1)
+    this->launched(g, pid);
+}
+
+void gaggled::Program::exec_failed(Gaggled* g, const ExecFailure& failure) {
+  if (failure.reason == EXEC_FAIL_CHDIR)
+    std::cout << "failed to chdir(\"" << wd << "\")... errno=" << failure.err << std::endl;
+  // respawning won't fix this, and nothing that depends on it should be disturbed.
+  // an operator start tries again.
+  std::cout << *this << exec_failure_reason(failure.reason) << " errno=" << failure.err << ", not respawning." << std::endl;
+  this->down_type = "EXEC";
+  // whatever we resolved didn't run, so look for it again next time.
+  resolved.clear();
+
+  // it was never up, but listeners should hear that it didn't come up and why.
+  this->backoff_wait = 0;
+  this->statechanges++;
+  g->broadcast_state(this);
+}
+
+void gaggled::Program::spawned(Gaggled* g, pid_t pid, const ExecFailure& failure) {
+  this->spawning = false;
+  if (failure.reason != 0) {
+    // a child whose exec failed is ours to reap, but was never this program running.
+    if (pid != -1)
+      g->discard_child(pid);
+    this->exec_failed(g, failure);
+    g->program_down(this);
+    return;
+  }
+
+  if (pid == -1) {
+    std::cout << "could not fork for " << name << ", errno=" << failure.err << std::endl;
+    g->program_down(this);
+    return;
+  }
+
+  this->launched(g, pid);
+
+  // anything that tried to stop it while it was being spawned gets done now.
+  if ((not g->is_running() and g->may_stop(this)) or this->operator_shutdown) {
+    new KillEvent(g, this, false, true);
+  } else if (this->deferred_signal != 0) {
+    this->kill_program(g, this->deferred_signal, this->deferred_prop_start, 0);
+  }
+  this->deferred_signal = 0;
+}
+
+void gaggled::Program::spawn_lost(Gaggled* g) {
+  this->spawning = false;
+  this->deferred_signal = 0;
+  this->request_start(g);
+  g->program_down(this);
+}
+
+bool gaggled::Program::is_spawning() {
+  return this->spawning;
+}
+
+void gaggled::Program::launched(Gaggled* g, pid_t pid) {
+  controlled_shutdown = false; // We're not in a controlled shutdown right now.  We just started, so that can't be true.
+  g->pid_map[pid] = this;
+  this->pid = pid;
+  // the child can't have been reaped yet (only check_deaths() does that) so this is the
+  // process we just forked, even if it has already exited. falls back to kill() on -1.
+  this->pidfd = gaggled_pidfd_open(pid);
+  this->token = gaggled::Program::instance_token++;
+  this->statechanges++;
+  this->running = true;
+  // started again once the pause was over; another death soon after trips it again.
+  this->churning = false;
+  this->down_type = "UNK";
+  this->prop_start = false;
+  this->stop_sent = 0;
+  this->stop_killed = 0;
+  // forking many programs in one pass can take a while, so don't trust the loop's reading.
+  this->started = gaggled::Clock::update();
+
+  std::cout << "forked for " << (*this) << std::endl;
+
+  if (this->output_r != -1) {
+    g->capture_output(this, this->output_r);
+    this->output_r = -1;
+  }
+
+  // anything that was waiting on this program to start can now work out when its
+  // dependency will be satisfied.
+  this->release_parked(true);
+
+  // broadcast the up state
+  g->broadcast_state(this);
+}
+
+pid_t gaggled::Program::spawn(ExecFailure* failure, bool reap_failed) {
+  failure->reason = 0;
+  failure->err = 0;
+  if (not this->open_stdio(failure))
+    return -1;
+  // built for this start only, out of strings the environments keep.
+  char** envp = this->environment_block();
+  pid_t pid;
+  if (this->spawn_method == SPAWN_POSIX_SPAWN)
+    pid = this->spawn_posix(failure, reap_failed, envp);
+  else
+    pid = this->spawn_fork(failure, reap_failed, envp);
+  free(envp);
+  this->close_stdio(pid != -1 and failure->reason == 0);
+  return pid;
+}
+
+pid_t gaggled::Program::spawn_posix(ExecFailure* failure, bool reap_failed, char** envp) {
+#ifndef GAGGLED_HAVE_SPAWN_CHDIR
+  if (wd != "") {
+    // no portable way to chdir in posix_spawn before glibc 2.29
+    return this->spawn_fork(failure, reap_failed, envp);
+  }
+#endif
+#ifndef GAGGLED_HAVE_SPAWN_CLOSEFROM
+  // nor to close the fds the child shouldn't inherit before glibc 2.34
+  return this->spawn_fork(failure, reap_failed, envp);
+#endif
+  // nor at all to start it in a cgroup.
+  if (this->cgroup != "")
+    return this->spawn_fork(failure, reap_failed, envp);
+
+  // the unlimited core size comes from gaggled's own, raised by Gaggled::unlimit_core().
+  posix_spawnattr_t attr;
+  posix_spawnattr_init(&attr);
+  // gaggled blocks SIGCHLD to receive it through a signalfd; don't pass that on.
+  sigset_t unblock;
+  sigemptyset(&unblock);
+  posix_spawnattr_setsigmask(&attr, &unblock);
+  short flags = POSIX_SPAWN_SETSIGMASK;
+  if (this->process_group) {
+    posix_spawnattr_setpgroup(&attr, 0);
+    flags |= POSIX_SPAWN_SETPGROUP;
+  }
+  posix_spawnattr_setflags(&attr, flags);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+#ifdef GAGGLED_HAVE_SPAWN_CHDIR
+  if (wd != "")
+    posix_spawn_file_actions_addchdir_np(&actions, wd.c_str());
+#endif
+  for (int i = 0; i != 3; i++)
+    if (this->child_stdio[i] >= 0)
+      posix_spawn_file_actions_adddup2(&actions, this->child_stdio[i], i);
+  if (this->child_stdio[2] == STDIO_AS_STDOUT)
+    posix_spawn_file_actions_adddup2(&actions, 1, 2);
+#ifdef GAGGLED_HAVE_SPAWN_CLOSEFROM
+  // everything else but the passed fds is closed, in as many actions as there are
+  // passed fds however far apart they are: they're packed down from 3, everything above
+  // them closed, and they're put back. the dup2s leave them without FD_CLOEXEC, so the
+  // program inherits them. kept[i] >= 3 + i, so packing up from the bottom and putting
+  // back from the top never overwrites one that's still needed.
+  int kept[PASSFDS_MAX + 1];
+  int n_kept = (int) kept_fds(this->pass_fds, -1, kept);
+  for (int i = 0; i != n_kept; i++)
+    posix_spawn_file_actions_adddup2(&actions, kept[i], 3 + i);
+  posix_spawn_file_actions_addclosefrom_np(&actions, 3 + n_kept);
+  for (int i = n_kept - 1; i >= 0; i--)
+    posix_spawn_file_actions_adddup2(&actions, 3 + i, kept[i]);
+  for (int i = 0; i != n_kept; i++)
+    if (not is_kept(3 + i, kept, n_kept))
+      posix_spawn_file_actions_addclose(&actions, 3 + i);
+#endif
+
+  // same search as the forked child does, but exec failures come back to us directly
+  bool err_perm = false;
+  bool err_badbin = false;
+  bool err_neverfound = true;
+  bool err_chdir = false;
+  int last_errno = 0;
+  pid_t pid = -1;
+  char* argv0 = exec_argv[0];
+
+  const std::vector<std::string>& candidates = this->exec_candidates();
+  for (auto c = candidates.begin(); c != candidates.end(); c++) {
+    exec_argv[0] = const_cast<char*>(c->c_str());
+    int rc = posix_spawn(&pid, exec_argv[0], &actions, &attr, exec_argv, envp);
+    if (rc == 0)
+      break;
+
+    pid = -1;
+    last_errno = rc;
+    if (rc == ENOENT and wd != "" and access(wd.c_str(), X_OK) != 0) {
+      // the chdir failed, not the exec; no other candidate will do better.
+      err_chdir = true;
+      break;
+    }
+    bool notfound;
+    classify_exec_error(rc, exec_argv[0], &err_perm, &err_badbin, &notfound);
+    err_neverfound = err_neverfound and notfound;
+  }
+  exec_argv[0] = argv0;
+
+  posix_spawn_file_actions_destroy(&actions);
+  posix_spawnattr_destroy(&attr);
+
+  if (pid == -1) {
+    failure->reason = (err_chdir ? EXEC_FAIL_CHDIR : exec_failure_reason_code(err_perm, err_neverfound, err_badbin));
+    failure->err = last_errno;
+  }
+
+  return pid;
+}
+
+pid_t gaggled::Program::spawn_fork(ExecFailure* failure, bool reap_failed, char** envp) {
+  // the child writes why its exec failed down this pipe; a successful exec closes it
+  // with nothing written.
+  int report[2];
+  if (pipe2(report, O_CLOEXEC) != 0) {
+    std::cout << "warning: pipe2() failed, errno=" << errno << ", exec failures of " << name << " will look like deaths." << std::endl;
+    report[0] = report[1] = -1;
+  }
+
+  std::string path = this->resolved_path();
+  char** candidates = this->candidate_block(path);
   pid_t pid = fork();
   if (pid == 0) {
-    // try to behave similarly to glibc execvpe
-    bool err_perm = false;
-    bool err_badbin = false;
-    bool err_neverfound = true;
-
-    if (wd != "") {
-      if (chdir(wd.c_str()) != 0)
-        {
-        std::cout << "failed to chdir(\"" << wd << "\")... errno=" << errno << std::endl << std::flush;
-        exit(EX_UNAVAILABLE);
-        }
+    if (report[0] != -1)
+      close(report[0]);
+    this->exec_child(candidates, envp, report[1]);
+  } else if (pid == -1) {
+    std::cout << "fork failed." << std::endl;
+  }
+  free(candidates);
+
+  if (report[0] == -1)
+    return pid;
+  close(report[1]);
+
+  if (pid != -1) {
+    ssize_t r;
+    do {
+      r = read(report[0], failure, sizeof(*failure));
+    } while (r == -1 and errno == EINTR);
+
+    if (r == sizeof(*failure)) {
+      // it exits right after writing; reap it here so it never shows up as a death.
+      // off the loop's thread that would race check_deaths(), so leave it to the loop.
+      while (reap_failed and waitpid(pid, NULL, 0) == -1 and errno == EINTR)
+        ;
+    } else {
+      failure->reason = 0;
     }
+  }
+  close(report[0]);
+  return pid;
+}
 
+void gaggled::Program::exec_child(char** candidates, char** envp, int report_fd) {
+  // this runs between fork and exec while gaggled may have other threads, so it only
+  // makes async-signal-safe calls and touches memory set up before the fork.
+
+  // gaggled blocks SIGCHLD to receive it through a signalfd; don't pass that on.
+  sigset_t unblock;
+  sigemptyset(&unblock);
+  sigprocmask(SIG_SETMASK, &unblock, NULL);
+
+  // try to behave similarly to glibc execvpe
+  bool err_perm = false;
+  bool err_badbin = false;
+  bool err_neverfound = true;
+  ExecFailure failure;
+
+  // before exec, so nothing it starts can be outside its group or cgroup. gaggled only
+  // learns the pid once the exec is done, so it can't signal the group too early.
+  if (this->process_group)
+    setpgid(0, 0);
+
+  if (this->cgroup != "" and not join_cgroup(this->cgroup_procs.c_str())) {
+    failure.reason = EXEC_FAIL_CGROUP;
+    failure.err = errno;
+  } else if (wd != "" and chdir(wd.c_str()) != 0) {
+    failure.reason = EXEC_FAIL_CHDIR;
+    failure.err = errno;
+  } else {
     struct rlimit inf;
     inf.rlim_cur = RLIM_INFINITY;
     inf.rlim_max = RLIM_INFINITY;
     setrlimit(RLIMIT_CORE, &inf);
 
-    for (auto c = commands.begin(); c != commands.end(); c++) {
-      exec_argv[0] = strdup(c->c_str());
-      execve(exec_argv[0], exec_argv, exec_env);
-
-      bool notfound = false;
-
-      switch (errno) {
-        case EACCES:
-          // execve sets EACCESS when the file is not a regular file,
-          // but this really should be counted as no binary found instead
-          struct stat st_buf;
-          stat(exec_argv[0], &st_buf);
-          if (S_ISREG(st_buf.st_mode)) {
-            err_perm = true;
-          } else {
-            notfound = true;
-          }            
-          break;
-        case ENOENT:
-        case ESTALE:
-        case ENOTDIR:
-        case ETIMEDOUT:
-        case ENODEV:
-          notfound = true;
-          break;
-        case ENOEXEC:
-          err_badbin = true;
-          break;
-      }
-
+    // the program gets the stdio it was configured with, the fds passed to it and
+    // nothing else gaggled has open.
+    for (int i = 0; i != 3; i++)
+      if (this->child_stdio[i] >= 0)
+        dup2(this->child_stdio[i], i);
+    if (this->child_stdio[2] == STDIO_AS_STDOUT)
+      dup2(1, 2);
+    for (auto f = this->pass_fds.begin(); f != this->pass_fds.end(); f++)
+      fcntl(*f, F_SETFD, 0);
+    int kept[PASSFDS_MAX + 1];
+    close_inherited_fds(kept, kept_fds(this->pass_fds, report_fd, kept));
+
+    failure.err = 0;
+    for (char** c = candidates; *c != NULL; c++) {
+      exec_argv[0] = *c;
+      execve(exec_argv[0], exec_argv, envp);
+      failure.err = errno;
+
+      bool notfound;
+      classify_exec_error(errno, exec_argv[0], &err_perm, &err_badbin, &notfound);
       err_neverfound = err_neverfound and notfound;
-
-      free(exec_argv[0]);
-    }
-
-    // In the case that this function is still executing, execv has failed every time. Try to figure out why, pass
-    // back information about such failure to the parent via exit()
-    if (err_perm) {
-      exit(EX_NOPERM);
-    } else if (err_neverfound) {
-      exit(EX_NOINPUT);
-    } else if (err_badbin) {
-      exit(EX_DATAERR);
-    } else {
-      exit(EX_UNAVAILABLE);
     }
-  } else if (pid == -1) {
-    std::cout << "fork failed." << std::endl;
-  } else {
-    controlled_shutdown = false; // We're not in a controlled shutdown right now.  We just started, so that can't be true.
-    g->pid_map[pid] = this;
-    this->pid = pid;
-    this->token = gaggled::Program::instance_token++;
-    this->statechanges++;
-    this->running = true;
-    this->down_type = "UNK";
-    this->prop_start = false;
-    if (gettimeofday(&(this->started), NULL) != 0)
-      std::cout << "error: failed to gettimeofday(), timing behaviour warning." << std::endl;
-
-    std::cout << "forked for " << (*this) << std::endl;
+    failure.reason = exec_failure_reason_code(err_perm, err_neverfound, err_badbin);
+  }
 
-    // broadcast the up state
-    g->broadcast_state(this);
+  // execve has failed every time. tell the parent why; the exit status means nothing.
+  // _exit so that none of gaggled's buffered output is flushed a second time.
+  if (report_fd != -1) {
+    ssize_t rc = write(report_fd, &failure, sizeof(failure));
+    (void) rc;
   }
+  _exit(127);
 }
 
 void gaggled::Program::kill_program(Gaggled* g, int signal, bool prop_start, unsigned long long token) {
+  if (this->spawning) {
+    // there's no pid to signal until the spawner replies; spawned() sends it then.
+    this->deferred_signal = signal;
+    this->deferred_prop_start = prop_start;
+    return;
+  }
+
   if (not this->running) {
     if (prop_start) {
       // if it's already dead, then the died process has already passed.
-      // there could already be a StartEvent queued, but we don't know that for sure.
-      // best make another one.
+      // there could already be a StartEvent queued; request_start() will reuse it if so.
       // the normal case where the died() function will create a restart is impossible here.
-      new gaggled::StartEvent(g, this);
+      this->request_start(g);
     }
     return;
   }
@@ -312,7 +1030,7 @@ void gaggled::Program::kill_program(Gaggled* g, int signal, bool prop_start, uns
   // program is running and are doing a prop kill: of course we set prop_start
   this->prop_start = prop_start;
 
-  int kr = kill(this->pid, signal);
+  int kr = this->signal_program(signal);
   if (kr == -1) {
     switch (errno) {
       case EINVAL :
@@ -332,68 +1050,168 @@ void gaggled::Program::kill_program(Gaggled* g, int signal, bool prop_start, uns
     // is considered controlled.  If kill failed to send, then it shouldn't die, so we don't want
     // to mark it as controlled.
     controlled_shutdown = true;
+    if (this->stop_sent == 0)
+      this->stop_sent = gaggled::Clock::now();
+    if (signal == SIGKILL and this->stop_killed == 0)
+      this->stop_killed = gaggled::Clock::now();
     std::cout << "[gaggled] " << name << ": killing with signal " << signal << std::endl << std::flush;
   }
  
   return;
 }
 
+int gaggled::Program::signal_program(int signal) {
+  // the leader isn't reaped until after we're done with it, so while it's running its
+  // pid can't have been reused for another process or group. if it's still in its own
+  // group, signalling the group reaches it and everything it started.
+  int kr;
+  bool group = (this->process_group and getpgid(this->pid) == this->pid);
+  if (group) {
+    kr = kill(-this->pid, signal);
+  } else if (this->pidfd != -1) {
+    kr = gaggled_pidfd_send_signal(this->pidfd, signal);
+  } else {
+    kr = kill(this->pid, signal);
+  }
+
+  // and whatever in its cgroup left the group, or never had one.
+  if (this->cgroup != "") {
+    int err = errno;
+    this->signal_cgroup(signal, group);
+    errno = err;
+  }
+  return kr;
+}
+
+int gaggled::Program::signal_cgroup(int signal, bool skip_group) {
+  // the kernel kills a whole cgroup in one go where it can (5.14 and later).
+  if (signal == SIGKILL) {
+    int fd = open((this->cgroup + "/cgroup.kill").c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd != -1) {
+      bool killed = (write(fd, "1", 1) == 1);
+      close(fd);
+      if (killed)
+        return 0;
+    }
+  }
+
+  // otherwise one at a time, leaving out the leader and its group if they've had it.
+  FILE* procs = fopen(this->cgroup_procs.c_str(), "re");
+  if (procs == NULL)
+    return 0;
+  int signalled = 0;
+  long member;
+  while (fscanf(procs, "%ld", &member) == 1) {
+    pid_t m = (pid_t) member;
+    if (m == this->pid or (skip_group and getpgid(m) == this->pid))
+      continue;
+    if (kill(m, signal) == 0)
+      signalled++;
+  }
+  fclose(procs);
+  return signalled;
+}
+
+void gaggled::Program::kill_leftovers(pid_t pid) {
+  // anything the program started that outlived it would hold on to whatever the next
+  // start needs. its group's id can't be reused while the group has members.
+  bool left = false;
+  if (this->process_group and kill(-pid, SIGKILL) == 0)
+    left = true;
+  if (this->cgroup != "" and this->signal_cgroup(SIGKILL, false) != 0)
+    left = true;
+  if (left)
+    std::cout << "[gaggled] " << name << ": sent SIGKILL to what it left in its process group or cgroup." << std::endl << std::flush;
+}
+
 void gaggled::Program::died(Gaggled* g, std::string down_type, int rcode) {
   std::cout << "I died, says " << (*this) << std::endl;
+  uint64_t up_ms = this->uptime();
+
+  // how long it took to go once asked, or if it had to be killed, how long it was given.
+  if (this->controlled_shutdown and this->stop_sent != 0) {
+    if (this->stop_killed == 0)
+      this->stop_latency.record((gaggled::Clock::now() - this->stop_sent) / NSEC_PER_MSEC);
+    else
+      this->stop_latency.record_killed((this->stop_killed - this->stop_sent) / NSEC_PER_MSEC);
+  }
+  this->stop_sent = 0;
+  this->stop_killed = 0;
 
   g->pid_map.erase(this->pid);
+  this->kill_leftovers(this->pid);
   this->pid = 0;
+  if (this->pidfd != -1) {
+    close(this->pidfd);
+    this->pidfd = -1;
+  }
   this->running = false;
   this->down_type = down_type;
   this->token = PTOK_INVAL;
   this->statechanges++;
+  // only deaths gaggled didn't ask for count towards churning.
+  if (not this->controlled_shutdown and this->note_death())
+    this->churning = true;
 
-  switch (rcode) {
-    case EX_NOPERM:
-      std::cout << *this << " was not executable due to permissions." << std::endl;
-      break;
-    case EX_DATAERR:
-      std::cout << *this << " executable format bad." << std::endl;
-      break;
-    case EX_NOINPUT:
-      std::cout << *this << " file not found." << std::endl;
-      break;
-    case EX_UNAVAILABLE:
-      std::cout << *this << " could not execute for an unknown reason." << std::endl;
-      break;
-  }
+  // a plain respawn waits out the backoff, worked out now so the down state says how long.
+  bool backing_off = (not this->churning and not this->prop_start and this->respawn);
+  this->backoff_wait = (backing_off ? this->backoff.next(up_ms) : 0);
 
   // broadcast the down state
   g->broadcast_state(this);
 
   // if respawn and/or prop_start from a previous kill, start now
-  if (this->prop_start) {
+  if (this->churning) {
+    bool restart = this->prop_start or this->respawn;
+    this->prop_start = false;
+    std::cout << "[gaggled] " << name << ": died " << this->deaths.size() << " times within " << this->churn.window << "ms, churning";
+    if (not restart)
+      std::cout << std::endl << std::flush;
+    else if (this->churn.pause > 0)
+      std::cout << ", respawning in " << this->churn.pause << "ms" << std::endl << std::flush;
+    else
+      std::cout << ", not respawning until started" << std::endl << std::flush;
+    if (restart and this->churn.pause > 0)
+      this->request_start(g, this->churn.pause);
+  } else if (this->prop_start) {
     // unflag
     this->prop_start = false;
-    new gaggled::StartEvent(g, this);
+    this->request_start(g);
   } else if (this->respawn) {
-    new gaggled::StartEvent(g, this);
+    // something that keeps dying shortly after starting is respawned less and less often.
+    int delay = this->backoff_wait;
+    if (delay > 0)
+      std::cout << "[gaggled] " << name << ": died after " << up_ms << "ms, respawning in " << delay << "ms" << std::endl << std::flush;
+    this->request_start(g, delay);
   }
 
   // So this program has died: doesn't matter why, if anything propagate=true depends
   // on this, we need to kill/restart it.
-  for (auto i = this->dependencies->begin(); i != this->dependencies->end(); i++)
-    if ((*i)->is_on(this))
-      (*i)->prop_down(g);
+  gaggled::Dependency** end = this->graph->inbound_end(this->index);
+  for (gaggled::Dependency** i = this->graph->inbound_begin(this->index); i != end; i++)
+    (*i)->prop_down(g);
+
+  // and on the way out, whatever it depended on may now be stopped.
+  g->program_down(this);
+}
+
+bool gaggled::Program::note_death() {
+  if (this->churn.deaths <= 0)
+    return false;
+
+  uint64_t now = gaggled::Clock::now();
+  uint64_t window = (uint64_t) this->churn.window * NSEC_PER_MSEC;
+  this->deaths.push_back(now);
+  while (now - this->deaths.front() > window or this->deaths.size() > (size_t) this->churn.deaths)
+    this->deaths.pop_front();
+  return this->deaths.size() == (size_t) this->churn.deaths;
 }
 
 uint64_t gaggled::Program::uptime() {
   if (not this->running)
     return 0;
 
-  timeval uptime;
-  if (gettimeofday(&uptime, NULL) != 0)
-    std::cout << "error: failed to gettimeofday(), timing behaviour warning." << std::endl;
-
-  uint64_t ms = (uptime.tv_sec - started.tv_sec) * 1000;
-  ms += (uptime.tv_usec - started.tv_usec) / 1000;
-
-  return ms;
+  return (gaggled::Clock::now() - this->started) / NSEC_PER_MSEC;
 }
 
 bool gaggled::Program::is_up(int ms) {
@@ -401,41 +1219,12 @@ bool gaggled::Program::is_up(int ms) {
     return false;
   }
 
-  // we could do a difference by taking the differences between
-  // now and this->started and removing them from the ms var, but we'd
-  // overflow and end up thinking we didn't have enough uptime once 24.85 days
-  // went by.
-  // so instead, we'll wind back the clock to when we want the program
-  // to have started by.
-  timeval started_by;
-  if (gettimeofday(&started_by, NULL) != 0)
-    std::cout << "error: failed to gettimeofday(), timing behaviour warning." << std::endl;
-  // first, whole seconds
-  started_by.tv_sec -= ms / 1000;
-
-  int usec_minus = (ms % 1000) * 1000;
-  if (usec_minus <= started_by.tv_usec) {
-    // straight up subtraction, easy!
-    started_by.tv_usec -= usec_minus;
-  } else {
-    // we're wrapping around here. first, find out how far into the previous second
-    // we're going, then assign a new usec value based on that.
-    started_by.tv_usec = 1000000 - (usec_minus - started_by.tv_usec);
-    // since we went to the previous second, we need to decrement that too.
-    started_by.tv_sec--;
-  }
-
-  // now that we know when we want to have started by, check if we did.
-  if (this->started.tv_sec < started_by.tv_sec) {
-    // second is ahead
-    return true;
-  } else if (this->started.tv_sec == started_by.tv_sec and this->started.tv_usec <= started_by.tv_usec) {
-    // in the same second, but the usec boundary has passed
-    return true;
-  }
+  // 64 bits of nanoseconds won't overflow in any uptime we'll see.
+  return gaggled::Clock::now() - this->started >= (uint64_t) ms * NSEC_PER_MSEC;
+}
 
-  // nope, haven't been running long enough. better luck next time!
-  return false;
+uint64_t gaggled::Program::up_at(int ms) {
+  return this->started + (uint64_t) ms * NSEC_PER_MSEC;
 }
 
 unsigned long long gaggled::Program::get_token() {
@@ -444,21 +1233,30 @@ unsigned long long gaggled::Program::get_token() {
 
 void gaggled::Program::op_start(gaggled::Gaggled* g) {
   operator_shutdown = false;
+  // an operator start doesn't wait out a respawn backoff or a churn pause.
+  this->churning = false;
+  this->deaths.clear();
+  this->backoff.reset();
+  this->backoff_wait = 0;
   this->statechanges++;
   g->broadcast_state(this);
-  new StartEvent(g, this);
+  this->cancel_starts();
+  g->admission.forfeit(this);
+  this->request_start(g);
 }
 
 void gaggled::Program::op_kill(gaggled::Gaggled* g) {
-  new KillEvent(g, this, SIGTERM, false, false);
+  new KillEvent(g, this, false, false);
 }
 
 void gaggled::Program::op_shutdown(gaggled::Gaggled* g) {
   operator_shutdown = true;
   this->statechanges++;
   g->broadcast_state(this);
-  g->flush_starts(this);
-  new KillEvent(g, this, SIGTERM, false, false);
+  this->cancel_starts();
+  // the cancelled start may have held an admission reservation.
+  g->admission.forfeit(this);
+  new KillEvent(g, this, false, false);
 }
 
 bool gaggled::Program::is_operator_shutdown() {
@@ -472,13 +1270,86 @@ bool gaggled::Program::is_controlled_shutdown() {
 std::vector<gaggled::Dependency*> gaggled::Program::get_dependencies() {
   std::vector<gaggled::Dependency*> outbound;
 
-  for (auto d = dependencies->begin(); d != dependencies->end(); d++)
-    if ((*d)->is_of(this))
-      outbound.push_back(*d);
+  outbound.assign(this->graph->outbound_begin(this->index), this->graph->outbound_end(this->index));
 
   return outbound;
 }
 
+void gaggled::Program::track(gaggled::Event* e) {
+  e->pending_prev = NULL;
+  e->pending_next = this->pending;
+  if (this->pending != NULL)
+    this->pending->pending_prev = e;
+  this->pending = e;
+}
+
+void gaggled::Program::untrack(gaggled::Event* e) {
+  if (e->pending_prev != NULL)
+    e->pending_prev->pending_next = e->pending_next;
+  else
+    this->pending = e->pending_next;
+  if (e->pending_next != NULL)
+    e->pending_next->pending_prev = e->pending_prev;
+  e->pending_prev = e->pending_next = NULL;
+}
+
+std::vector<gaggled::Event*> gaggled::Program::pending_events() {
+  std::vector<gaggled::Event*> events;
+  for (gaggled::Event* e = this->pending; e != NULL; e = e->pending_next)
+    events.push_back(e);
+  return events;
+}
+
+void gaggled::Program::request_start(gaggled::Gaggled* g, int delay) {
+  // at most one start is armed per program; any further request is already covered by it.
+  for (gaggled::Event* e = this->pending; e != NULL; e = e->pending_next) {
+    if (dynamic_cast<gaggled::StartEvent*>(e) != NULL) {
+      g->coalesced_starts++;
+      return;
+    }
+  }
+  new gaggled::StartEvent(g, this, delay);
+}
+
+void gaggled::Program::cancel_starts() {
+  gaggled::Event* e = this->pending;
+  while (e != NULL) {
+    gaggled::Event* next = e->pending_next;
+    if (dynamic_cast<gaggled::StartEvent*>(e) != NULL)
+      e->cancel();
+    e = next;
+  }
+}
+
+void gaggled::Program::park(gaggled::Event* e) {
+  e->parked_on = this;
+  this->parked.push_back(e);
+}
+
+void gaggled::Program::unpark(gaggled::Event* e) {
+  e->parked_on = NULL;
+  for (auto i = this->parked.begin(); i != this->parked.end(); i++) {
+    if (*i == e) {
+      this->parked.erase(i);
+      return;
+    }
+  }
+}
+
+void gaggled::Program::release_parked(bool requeue) {
+  std::vector<gaggled::Event*> released;
+  released.swap(this->parked);
+  for (auto e = released.begin(); e != released.end(); e++) {
+    (*e)->parked_on = NULL;
+    if (requeue) {
+      (*e)->set_delay(0);
+      (*e)->queue();
+    } else {
+      delete *e;
+    }
+  }
+}
+
 std::ostream& gaggled::operator<< (std::ostream &stream, gaggled::Program& p) {
   stream << (&p)->to_string();
   return stream;
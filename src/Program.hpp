@@ -26,32 +26,85 @@
 #include <string>
 #include <map>
 #include <vector>
-#include <sys/time.h>
+#include <set>
+#include <deque>
+#include <stdint.h>
 #include "Gaggled.hpp"
+#include "ExecFailure.hpp"
+#include "StopPolicy.hpp"
+#include "Admission.hpp"
+#include "Backoff.hpp"
+#include "Environment.hpp"
+
+#define SPAWN_FORK 0
+#define SPAWN_POSIX_SPAWN 1
+#define SPAWN_SPAWNER 2
+
+// most fds one program can be passed
+#define PASSFDS_MAX 64
 
 namespace gaggled {
 class Dependency;
+class DependencyGraph;
+class Event;
+
 class Program
 {
 public:
   Program(std::string name, std::string command, std::vector<std::string>* argv, std::map<std::string, std::string> own_env, std::string wd, bool respawn, bool enabled);
   ~Program();
-  void overlay_environment(std::map<std::string, std::string> global_environment);
+  void set_environment(const Environment* environment);
+  // stream 0, 1 or 2 goes to "" (inherited), "null", "pipe", "stdout" or a file.
+  void set_stdio(int stream, const std::string& to);
+  bool redirects_stdio();
+  void set_pass_fds(const std::vector<int>& fds);
+  void set_process_group(bool process_group);
+  void set_stop_steps(const std::vector<StopStep>& steps);
+  const std::vector<StopStep>& get_stop_steps();
+  void set_adaptive_kill(const AdaptiveKillPolicy& policy);
+  int kill_after();
+  uint64_t stop_percentile(double q);
+  size_t stop_samples();
+  void set_cgroup(const std::string& cgroup);
+  std::string get_cgroup();
   std::string to_string();
   std::string getName();
+  size_t get_index();
+  void set_index(size_t index);
   bool search(std::vector<std::string>* path);
-  void add_dependency(Dependency* d);
+  void search_dirs(std::set<std::string>* dirs);
+  void set_graph(DependencyGraph* graph);
+  void set_spawn_method(int spawn_method);
+  int get_spawn_method();
+  size_t get_depth();
+  void set_depth(size_t depth);
+  int get_ready();
+  void set_ready(int ready);
+  int get_group();
+  void set_group(int group);
+  int get_admission();
+  void set_admission(int admission);
+  void set_backoff(const BackoffPolicy& policy);
+  int get_backoff();
+  void set_churn(const ChurnPolicy& policy);
+  const ChurnPolicy& get_churn();
+  bool is_churning();
   bool is_running();
   pid_t get_pid();
   std::string getDownType();
   uint64_t state_changes();
   std::string get_command();
   bool dependencies_satisfied();
+  Dependency* unsatisfied_dependency();
   void start(Gaggled* g);
+  void spawned(Gaggled* g, pid_t pid, const ExecFailure& failure);
+  void spawn_lost(Gaggled* g);
+  bool is_spawning();
   void kill_program(Gaggled* g, int signal, bool prop_start, unsigned long long token);
   void died(Gaggled* g, std::string down_type, int rcode);
   uint64_t uptime();
   bool is_up(int ms);
+  uint64_t up_at(int ms);
   unsigned long long get_token();
   void op_start(Gaggled* g);
   void op_kill(Gaggled* g);
@@ -59,31 +112,112 @@ public:
   bool is_operator_shutdown();
   bool is_controlled_shutdown();
   std::vector<Dependency*> get_dependencies();
+  void track(Event* e);
+  void untrack(Event* e);
+  std::vector<Event*> pending_events();
+  void request_start(Gaggled* g, int delay = 0);
+  void cancel_starts();
+  void park(Event* e);
+  void unpark(Event* e);
+  void release_parked(bool requeue);
 private:
+  friend class Spawner;
+  friend class SpawnPool;
   //global statics
   static unsigned long long instance_token;
   // run-length settings
   std::string name;
+  size_t index;
   std::string command;
   std::vector<std::string> commands;
+  // the first of commands that was an executable file at the last lookup, if any
+  std::vector<std::string> resolved;
+  uint64_t resolved_generation;
   std::vector<std::string>* argv;
   std::string wd;
-  std::map<std::string, std::string> own_env;
-  std::vector<Dependency*>* dependencies;
+  // the environment shared by every program, and this one's additions to it
+  const Environment* environment;
+  Environment own_env;
+  std::string stdio[3];
+  // sorted fds of gaggled's the program keeps at the same numbers
+  std::vector<int> pass_fds;
+  // the signals it's stopped with, in order, ending with SIGKILL
+  std::vector<StopStep> stop_steps;
+  AdaptiveKillPolicy adaptive_kill;
+  // started as the leader of its own process group, which is signalled along with it
+  bool process_group;
+  // the cgroup directory it is started in, "" to stay in gaggled's; and the file the
+  // child writes itself into, built here so the child doesn't allocate
+  std::string cgroup;
+  std::string cgroup_procs;
+  DependencyGraph* graph;
+  int spawn_method;
+  // longest chain of dependencies below this program
+  size_t depth;
+  // ms after starting that it stops counting against maxstarting
+  int ready;
+  // admission control group, -1 for none
+  int group;
   bool respawn;
   bool operator_shutdown;
   // FIXME is this ever true? What's the use of it?
   bool controlled_shutdown;
   char **exec_argv;
-  char **exec_env;
+  bool resolve();
+  std::string resolved_path();
+  const std::vector<std::string>& exec_candidates();
+  pid_t spawn(ExecFailure* failure, bool reap_failed);
+  char** environment_block();
+  char** candidate_block(const std::string& path);
+  bool open_stdio(ExecFailure* failure);
+  void close_stdio(bool launched);
+  pid_t spawn_fork(ExecFailure* failure, bool reap_failed, char** envp);
+  pid_t spawn_posix(ExecFailure* failure, bool reap_failed, char** envp);
+  void exec_child(char** candidates, char** envp, int report_fd);
+  int signal_program(int signal);
+  int signal_cgroup(int signal, bool skip_group);
+  void kill_leftovers(pid_t pid);
+  void launched(Gaggled* g, pid_t pid);
+  void exec_failed(Gaggled* g, const ExecFailure& failure);
+  bool note_death();
   // changable state
   bool running;
+  // handed to the spawner and waiting for its reply; a kill meanwhile is held here
+  bool spawning;
+  int deferred_signal;
+  bool deferred_prop_start;
+  // respawn delay after dying too soon, and what the latest death is waiting out
+  Backoff backoff;
+  int backoff_wait;
+  ChurnPolicy churn;
+  // when recent deaths gaggled didn't cause happened, oldest first
+  std::deque<uint64_t> deaths;
+  // died too often lately, restarts are paused
+  bool churning;
+  // ADMIT_*
+  int admission;
   std::string down_type;
   bool prop_start;
   pid_t pid;
-  timeval started;
+  int pidfd;
+  // when this instance was first signalled to stop and when it was sent SIGKILL, 0 if
+  // it hasn't been; how long past stops took
+  uint64_t stop_sent;
+  uint64_t stop_killed;
+  StopLatency stop_latency;
+  // what the child being spawned dup2()s onto its stdio, -1 to leave it be
+  int child_stdio[3];
+  // both ends of the pipe its output is captured through while spawning; the read end
+  // is handed to gaggled once it's running
+  int output_r;
+  int output_w;
+  uint64_t started;
   unsigned long long token;
   uint64_t statechanges;
+  // intrusive list of queued events that act on this program
+  Event* pending;
+  // events waiting for this program to start
+  std::vector<Event*> parked;
 };
 std::ostream &operator<< (std::ostream &stream, Program& p);
 }
@@ -0,0 +1,250 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/inotify.h>
+#endif
+#include <iostream>
+#include "Reactor.hpp"
+
+gaggled::Reactor::Reactor() :
+  epoll_fd(-1),
+  timer_fd(-1),
+  wake_r(-1),
+  wake_w(-1),
+  control_fd(-1),
+  child_fd(-1),
+  paths_fd(-1),
+  spawner_fd(-1)
+{
+  // self-pipe for wake(); both ends nonblocking so a signal handler can never block
+  // on a full pipe and draining never blocks the loop.
+  int fds[2];
+  if (pipe(fds) != 0) {
+    std::cout << "error: failed to create wakeup pipe, errno=" << errno << std::endl;
+  } else {
+    wake_r = fds[0];
+    wake_w = fds[1];
+    for (int i = 0; i != 2; i++) {
+      fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+      fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+    }
+  }
+
+#ifdef __linux__
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd == -1) {
+    std::cout << "error: epoll_create1() failed, errno=" << errno << std::endl;
+  } else {
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd == -1)
+      std::cout << "error: timerfd_create() failed, errno=" << errno << std::endl;
+    else
+      add(timer_fd, REACTOR_WAKE_TIMER);
+    if (wake_r != -1)
+      add(wake_r, REACTOR_WAKE_STOP);
+  }
+#endif
+}
+
+gaggled::Reactor::~Reactor() {
+  int fds[4] = {epoll_fd, timer_fd, wake_r, wake_w};
+  for (int i = 0; i != 4; i++)
+    if (fds[i] != -1)
+      close(fds[i]);
+}
+
+void gaggled::Reactor::add(int fd, int tag) {
+#ifdef __linux__
+  if (epoll_fd == -1)
+    return;
+  struct epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.u64 = 0;
+  ev.data.u32 = tag;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    std::cout << "error: epoll_ctl(" << fd << ") failed, errno=" << errno << std::endl;
+#endif
+}
+
+void gaggled::Reactor::drain(int fd) {
+  char buf[64];
+  while (read(fd, buf, sizeof(buf)) > 0)
+    ;
+}
+
+void gaggled::Reactor::drain_paths() {
+#ifdef __linux__
+  // inotify events carry the name that changed, so a read has to fit a whole event
+  // with the longest name or it fails with EINVAL and leaves the event queued.
+  char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+  while (true) {
+    ssize_t r = read(paths_fd, buf, sizeof(buf));
+    if (r > 0)
+      continue;
+    if (r == -1 and errno == EINTR)
+      continue;
+    if (r == -1 and errno == EINVAL) {
+      // an event we can't take off the queue would wake every pass from now on.
+      std::cout << "warning: can't read PATH change events, looking PATH up again at every start." << std::endl;
+      unwatch(paths_fd);
+      paths_fd = -1;
+    }
+    return;
+  }
+#endif
+}
+
+void gaggled::Reactor::watch_control(int fd) {
+  control_fd = fd;
+  add(fd, REACTOR_WAKE_CONTROL);
+}
+
+void gaggled::Reactor::watch_children(int fd) {
+  child_fd = fd;
+  add(fd, REACTOR_WAKE_CHILD);
+}
+
+void gaggled::Reactor::watch_paths(int fd) {
+  paths_fd = fd;
+  add(fd, REACTOR_WAKE_PATHS);
+}
+
+bool gaggled::Reactor::watching_paths() {
+  return paths_fd != -1;
+}
+
+void gaggled::Reactor::watch_spawner(int fd) {
+  spawner_fd = fd;
+  add(fd, REACTOR_WAKE_SPAWNER);
+}
+
+void gaggled::Reactor::watch_output(int fd) {
+  output_fds.push_back(fd);
+  add(fd, REACTOR_WAKE_OUTPUT);
+}
+
+void gaggled::Reactor::unwatch_output(int fd) {
+  for (auto o = output_fds.begin(); o != output_fds.end(); o++) {
+    if (*o == fd) {
+      output_fds.erase(o);
+      break;
+    }
+  }
+  unwatch(fd);
+}
+
+void gaggled::Reactor::unwatch(int fd) {
+#ifdef __linux__
+  if (epoll_fd != -1) {
+    // kernels before 2.6.9 insist on an event even though it's ignored.
+    struct epoll_event ev;
+    ev.events = 0;
+    ev.data.u64 = 0;
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, &ev);
+  }
+#endif
+}
+
+void gaggled::Reactor::wake() {
+  if (wake_w == -1)
+    return;
+  char c = 0;
+  // if the pipe is full, a wakeup is already pending; nothing more to do.
+  ssize_t rc = write(wake_w, &c, 1);
+  (void) rc;
+}
+
+int gaggled::Reactor::wait(long usec) {
+  int ready = 0;
+
+#ifdef __linux__
+  if (epoll_fd != -1 and timer_fd != -1) {
+    // the timerfd carries the deadline at full resolution; epoll itself only ever
+    // blocks indefinitely or not at all. a zeroed it_value disarms the timer.
+    if (usec != 0) {
+      struct itimerspec its;
+      its.it_interval.tv_sec = 0;
+      its.it_interval.tv_nsec = 0;
+      if (usec > 0) {
+        its.it_value.tv_sec = usec / 1000000;
+        its.it_value.tv_nsec = (usec % 1000000) * 1000;
+      } else {
+        its.it_value.tv_sec = 0;
+        its.it_value.tv_nsec = 0;
+      }
+      if (timerfd_settime(timer_fd, 0, &its, NULL) != 0)
+        std::cout << "error: timerfd_settime() failed, errno=" << errno << std::endl;
+    }
+
+    struct epoll_event evs[8];
+    int n = epoll_wait(epoll_fd, evs, 8, (usec == 0 ? 0 : -1));
+    for (int i = 0; i < n; i++)
+      ready |= evs[i].data.u32;
+
+    if (ready & REACTOR_WAKE_TIMER)
+      drain(timer_fd);
+    if (ready & REACTOR_WAKE_STOP)
+      drain(wake_r);
+    if (ready & REACTOR_WAKE_PATHS)
+      drain_paths();
+    return ready;
+  }
+#endif
+
+  // portable fallback. poll() only has millisecond resolution; round up so we never
+  // wake before a deadline.
+  std::vector<struct pollfd> pfds;
+  std::vector<int> tags;
+  int fds[5] = {wake_r, control_fd, child_fd, paths_fd, spawner_fd};
+  int fd_tags[5] = {REACTOR_WAKE_STOP, REACTOR_WAKE_CONTROL, REACTOR_WAKE_CHILD, REACTOR_WAKE_PATHS, REACTOR_WAKE_SPAWNER};
+  for (size_t i = 0; i != 5 + output_fds.size(); i++) {
+    int fd = (i < 5 ? fds[i] : output_fds[i - 5]);
+    if (fd == -1)
+      continue;
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    pfds.push_back(pfd);
+    tags.push_back(i < 5 ? fd_tags[i] : REACTOR_WAKE_OUTPUT);
+  }
+
+  int timeout = (usec < 0 ? -1 : (usec + 999) / 1000);
+  int n = poll(pfds.empty() ? NULL : &pfds[0], pfds.size(), timeout);
+  if (n == 0)
+    ready |= REACTOR_WAKE_TIMER;
+  for (size_t i = 0; n > 0 and i != pfds.size(); i++)
+    if (pfds[i].revents != 0)
+      ready |= tags[i];
+
+  if (ready & REACTOR_WAKE_STOP)
+    drain(wake_r);
+  if (ready & REACTOR_WAKE_PATHS)
+    drain_paths();
+  return ready;
+}
@@ -0,0 +1,75 @@
+#ifndef GAGGLED_REACTOR_HPP_INCLUDED
+#define GAGGLED_REACTOR_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <vector>
+
+#define REACTOR_WAKE_CONTROL 1
+#define REACTOR_WAKE_CHILD 2
+#define REACTOR_WAKE_TIMER 4
+#define REACTOR_WAKE_STOP 8
+#define REACTOR_WAKE_PATHS 16
+#define REACTOR_WAKE_SPAWNER 32
+#define REACTOR_WAKE_OUTPUT 64
+
+namespace gaggled {
+// the one place the event loop blocks. waits on the control socket, child death
+// notifications, the next event deadline and wake() all at once. uses epoll and a
+// timerfd on Linux and plain poll() elsewhere.
+class Reactor
+{
+public:
+  Reactor();
+  ~Reactor();
+  void watch_control(int fd);
+  void watch_children(int fd);
+  void watch_paths(int fd);
+  // false once PATH changes can't be told apart, if they ever could.
+  bool watching_paths();
+  void watch_spawner(int fd);
+  // any number of these, one per pipe a program's output is read from.
+  void watch_output(int fd);
+  void unwatch_output(int fd);
+  // async-signal-safe: makes the current or next wait() return REACTOR_WAKE_STOP.
+  void wake();
+  // block for at most usec microseconds (forever if negative, not at all if 0) and
+  // return a mask of REACTOR_WAKE_* for whatever became ready.
+  int wait(long usec);
+private:
+  int epoll_fd;
+  int timer_fd;
+  int wake_r;
+  int wake_w;
+  int control_fd;
+  int child_fd;
+  int paths_fd;
+  int spawner_fd;
+  std::vector<int> output_fds;
+  void add(int fd, int tag);
+  void unwatch(int fd);
+  void drain(int fd);
+  void drain_paths();
+};
+}
+
+#endif
@@ -0,0 +1,165 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <signal.h>
+#include <errno.h>
+#include <string.h>
+#include <iostream>
+#include "SpawnPool.hpp"
+#include "Program.hpp"
+#include "Reactor.hpp"
+
+gaggled::SpawnPool::SpawnPool() :
+  stopping(false),
+  completed(NULL),
+  reactor(NULL),
+  outstanding(0)
+{
+  pthread_mutex_init(&lock, NULL);
+  pthread_cond_init(&ready, NULL);
+}
+
+gaggled::SpawnPool::~SpawnPool() {
+  stop();
+  pthread_cond_destroy(&ready);
+  pthread_mutex_destroy(&lock);
+}
+
+bool gaggled::SpawnPool::start(int workers, Reactor* reactor) {
+  this->reactor = reactor;
+
+  // signals are for the loop's thread, and children start from the worker's mask.
+  sigset_t all, old;
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+  for (int i = 0; i != workers; i++) {
+    pthread_t t;
+    int rc = pthread_create(&t, NULL, &gaggled::SpawnPool::work, this);
+    if (rc != 0) {
+      std::cout << "warning: could only start " << i << " of " << workers << " spawn workers, errno=" << rc << std::endl;
+      break;
+    }
+    threads.push_back(t);
+  }
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+  if (not threads.empty())
+    std::cout << "[gaggled] " << threads.size() << " spawn workers running." << std::endl;
+  return not threads.empty();
+}
+
+void gaggled::SpawnPool::stop() {
+  pthread_mutex_lock(&lock);
+  stopping = true;
+  pthread_cond_broadcast(&ready);
+  pthread_mutex_unlock(&lock);
+
+  for (auto t = threads.begin(); t != threads.end(); t++)
+    pthread_join(*t, NULL);
+  threads.clear();
+
+  // jobs never started and results never taken
+  while (not jobs.empty()) {
+    delete jobs.front();
+    jobs.pop();
+  }
+  SpawnJob* j = take_completed();
+  while (j != NULL) {
+    SpawnJob* next = j->next;
+    delete j;
+    j = next;
+  }
+  outstanding = 0;
+}
+
+bool gaggled::SpawnPool::is_running() {
+  return not threads.empty();
+}
+
+bool gaggled::SpawnPool::submit(Program* p) {
+  if (threads.empty())
+    return false;
+
+  SpawnJob* j = new SpawnJob();
+  j->p = p;
+  j->pid = -1;
+  j->failure.reason = 0;
+  j->failure.err = 0;
+  j->next = NULL;
+
+  pthread_mutex_lock(&lock);
+  jobs.push(j);
+  pthread_cond_signal(&ready);
+  pthread_mutex_unlock(&lock);
+
+  outstanding++;
+  return true;
+}
+
+gaggled::SpawnJob* gaggled::SpawnPool::take_completed() {
+  if (completed == NULL)
+    return NULL;
+
+  // take the whole stack at once; being the only taker means no ABA to worry about.
+  SpawnJob* taken = __sync_lock_test_and_set(&completed, (SpawnJob*) NULL);
+
+  // it's newest first, put it back in completion order
+  SpawnJob* ordered = NULL;
+  while (taken != NULL) {
+    SpawnJob* next = taken->next;
+    taken->next = ordered;
+    ordered = taken;
+    taken = next;
+    if (outstanding > 0)
+      outstanding--;
+  }
+  return ordered;
+}
+
+size_t gaggled::SpawnPool::in_flight() {
+  return outstanding;
+}
+
+void* gaggled::SpawnPool::work(void* arg) {
+  SpawnPool* pool = (SpawnPool*) arg;
+  while (true) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->jobs.empty() and not pool->stopping)
+      pthread_cond_wait(&pool->ready, &pool->lock);
+    if (pool->stopping) {
+      pthread_mutex_unlock(&pool->lock);
+      return NULL;
+    }
+    SpawnJob* j = pool->jobs.front();
+    pool->jobs.pop();
+    pthread_mutex_unlock(&pool->lock);
+
+    // a failed child is left for the loop to reap; it may well get there first.
+    j->pid = j->p->spawn(&j->failure, false);
+
+    SpawnJob* head;
+    do {
+      head = pool->completed;
+      j->next = head;
+    } while (not __sync_bool_compare_and_swap(&pool->completed, head, j));
+    pool->reactor->wake();
+  }
+}
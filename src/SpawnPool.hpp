@@ -0,0 +1,75 @@
+#ifndef GAGGLED_SPAWN_POOL_HPP_INCLUDED
+#define GAGGLED_SPAWN_POOL_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <sys/types.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <queue>
+#include <vector>
+#include "ExecFailure.hpp"
+
+namespace gaggled {
+class Program;
+class Reactor;
+
+struct SpawnJob {
+  Program* p;
+  pid_t pid;
+  ExecFailure failure;
+  SpawnJob* next;
+};
+
+// worker threads that fork and exec programs so that mass starts don't serialise on
+// the event loop. workers only ever touch the job they were handed; results come
+// back on a lock-free stack that the loop takes whole, so pid_map and all program
+// state stay the loop's alone.
+class SpawnPool
+{
+public:
+  SpawnPool();
+  ~SpawnPool();
+  bool start(int workers, Reactor* reactor);
+  void stop();
+  bool is_running();
+  bool submit(Program* p);
+  // everything finished since the last call, oldest first; the caller deletes them.
+  SpawnJob* take_completed();
+  size_t in_flight();
+private:
+  pthread_mutex_t lock;
+  pthread_cond_t ready;
+  // guarded by lock
+  std::queue<SpawnJob*> jobs;
+  bool stopping;
+  // pushed by workers, taken by the loop
+  SpawnJob* volatile completed;
+  std::vector<pthread_t> threads;
+  Reactor* reactor;
+  // loop only
+  size_t outstanding;
+  static void* work(void* arg);
+};
+}
+
+#endif
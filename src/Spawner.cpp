@@ -0,0 +1,219 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#endif
+#include <iostream>
+#include "Spawner.hpp"
+#include "Program.hpp"
+
+gaggled::Spawner::Spawner() :
+  pid(-1),
+  fd(-1),
+  outstanding(0),
+  hung_up(false)
+{}
+
+gaggled::Spawner::~Spawner() {
+  close_helper();
+}
+
+bool gaggled::Spawner::start(std::vector<Program*>* programs) {
+#ifdef __linux__
+  int sv[2];
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) != 0) {
+    std::cout << "warning: socketpair() for spawner failed, errno=" << errno << ", spawning directly." << std::endl;
+    return false;
+  }
+
+  pid_t gaggled_pid = getpid();
+  pid_t helper = fork();
+  if (helper == 0) {
+    close(sv[0]);
+    // if gaggled goes away there's nobody left to spawn for.
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != gaggled_pid)
+      _exit(0);
+    // ^C and friends are for gaggled, which closes the socket when it's done with us.
+    signal(SIGINT, SIG_IGN);
+    signal(SIGTERM, SIG_IGN);
+    signal(SIGUSR1, SIG_IGN);
+    serve(sv[1], programs);
+    _exit(0);
+  }
+
+  close(sv[1]);
+  if (helper == -1) {
+    close(sv[0]);
+    std::cout << "warning: fork() for spawner failed, errno=" << errno << ", spawning directly." << std::endl;
+    return false;
+  }
+
+  pid = helper;
+  fd = sv[0];
+  outstanding = 0;
+  std::cout << "[gaggled] spawner running, pid=" << pid << std::endl;
+  return true;
+#else
+  std::cout << "warning: spawner is only supported on Linux, spawning directly." << std::endl;
+  return false;
+#endif
+}
+
+void gaggled::Spawner::close_helper() {
+  // the helper exits when it reads end of file; either way gaggled reaps it, so the
+  // pid is kept to recognise that.
+  if (fd != -1)
+    close(fd);
+  fd = -1;
+  outstanding = 0;
+}
+
+bool gaggled::Spawner::is_running() {
+  return fd != -1;
+}
+
+pid_t gaggled::Spawner::get_pid() {
+  return pid;
+}
+
+int gaggled::Spawner::get_fd() {
+  return fd;
+}
+
+bool gaggled::Spawner::is_hung_up() {
+  return hung_up;
+}
+
+size_t gaggled::Spawner::in_flight() {
+  return outstanding;
+}
+
+bool gaggled::Spawner::request(Program* p, const std::string& path) {
+  if (fd == -1 or path.size() > SPAWNER_PATH_MAX)
+    return false;
+
+  SpawnRequest req;
+  req.index = p->get_index();
+  req.path_len = path.size();
+  memcpy(req.path, path.data(), path.size());
+
+  // a full socket means the helper is far behind; don't wait for it.
+  ssize_t sent = send(fd, &req, offsetof(SpawnRequest, path) + path.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+  if (sent == -1)
+    return false;
+
+  outstanding++;
+  return true;
+}
+
+bool gaggled::Spawner::read_reply(SpawnReply* reply) {
+  if (fd == -1)
+    return false;
+  ssize_t got = recv(fd, reply, sizeof(*reply), MSG_DONTWAIT);
+  if (got == 0)
+    hung_up = true;
+  if (got != sizeof(*reply))
+    return false;
+  if (outstanding > 0)
+    outstanding--;
+  return true;
+}
+
+void gaggled::Spawner::serve(int fd, std::vector<Program*>* programs) {
+#ifdef __linux__
+  SpawnRequest req;
+  while (true) {
+    ssize_t got = recv(fd, &req, sizeof(req), 0);
+    if (got == -1 and errno == EINTR)
+      continue;
+    if (got < (ssize_t) offsetof(SpawnRequest, path))
+      return;
+
+    SpawnReply reply;
+    reply.index = req.index;
+    reply.pid = -1;
+    reply.failure.reason = 0;
+    reply.failure.err = 0;
+
+    size_t path_len = got - offsetof(SpawnRequest, path);
+    if (req.index >= programs->size() or req.path_len != path_len) {
+      reply.failure.err = EINVAL;
+    } else {
+      int report[2];
+      if (pipe2(report, O_CLOEXEC) != 0) {
+        reply.failure.err = errno;
+      } else {
+        Program* p = (*programs)[req.index];
+        char** envp = p->environment_block();
+        std::string path(req.path, path_len);
+        char** candidates = p->candidate_block(path);
+        // the child's parent is gaggled, not us, so gaggled gets its SIGCHLD and can
+        // reap and signal it like any program it forked itself.
+#ifdef __s390__
+        pid_t child = syscall(SYS_clone, 0, CLONE_PARENT | SIGCHLD, 0, 0, 0);
+#else
+        pid_t child = syscall(SYS_clone, CLONE_PARENT | SIGCHLD, 0, 0, 0, 0);
+#endif
+        if (child == 0) {
+          close(report[0]);
+          signal(SIGINT, SIG_DFL);
+          signal(SIGTERM, SIG_DFL);
+          signal(SIGUSR1, SIG_DFL);
+          p->exec_child(candidates, envp, report[1]);
+        }
+        free(candidates);
+        free(envp);
+        if (child == -1)
+          reply.failure.err = errno;
+        reply.pid = child;
+        close(report[1]);
+
+        // nothing arrives before the pipe closes on a successful exec.
+        ssize_t r;
+        do {
+          r = read(report[0], &reply.failure, sizeof(reply.failure));
+        } while (r == -1 and errno == EINTR);
+        if (r != sizeof(reply.failure)) {
+          reply.failure.reason = 0;
+          if (child != -1)
+            reply.failure.err = 0;
+        }
+        close(report[0]);
+      }
+    }
+
+    if (send(fd, &reply, sizeof(reply), MSG_NOSIGNAL) != sizeof(reply))
+      return;
+  }
+#endif
+}
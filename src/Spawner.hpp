@@ -0,0 +1,82 @@
+#ifndef GAGGLED_SPAWNER_HPP_INCLUDED
+#define GAGGLED_SPAWNER_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "ExecFailure.hpp"
+
+// longest command path a spawn request can carry
+#define SPAWNER_PATH_MAX 4096
+
+namespace gaggled {
+class Program;
+
+struct SpawnRequest {
+  uint32_t index;
+  uint32_t path_len;
+  char path[SPAWNER_PATH_MAX];
+};
+
+// what became of a request: pid is -1 if the helper could not fork (failure.err says
+// why), otherwise the child exists and is ours to reap even if its exec failed.
+struct SpawnReply {
+  uint32_t index;
+  int32_t pid;
+  ExecFailure failure;
+};
+
+// a small helper process, forked once at startup while gaggled is still small, that
+// forks and execs programs on request over a unix socket. its children are created
+// with CLONE_PARENT so they are gaggled's own to signal and reap, and it waits for
+// each exec on a close-on-exec pipe so failures come back with the reply.
+class Spawner
+{
+public:
+  Spawner();
+  ~Spawner();
+  bool start(std::vector<Program*>* programs);
+  void close_helper();
+  bool is_running();
+  pid_t get_pid();
+  int get_fd();
+  size_t in_flight();
+  // the helper closed its end; it exited or is about to.
+  bool is_hung_up();
+  // false if the request could not be sent and the caller should spawn directly.
+  bool request(Program* p, const std::string& path);
+  // nonblocking; false once no more replies are waiting.
+  bool read_reply(SpawnReply* reply);
+private:
+  pid_t pid;
+  int fd;
+  size_t outstanding;
+  bool hung_up;
+  static void serve(int fd, std::vector<Program*>* programs);
+};
+}
+
+#endif
@@ -0,0 +1,84 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <algorithm>
+#include "StopPolicy.hpp"
+
+gaggled::StopLatency::StopLatency() :
+  count(0),
+  next(0),
+  killed(false)
+{}
+
+gaggled::AdaptiveKillPolicy gaggled::StopLatency::default_policy() {
+  AdaptiveKillPolicy policy;
+  policy.enabled = false;
+  policy.multiplier = 3.0;
+  policy.min = 1000;
+  policy.max = 0;
+  return policy;
+}
+
+void gaggled::StopLatency::record(uint64_t ms) {
+  // the oldest goes once the window is full, so the estimate follows the program.
+  this->ms[this->next] = (uint32_t) std::min(ms, (uint64_t) 0xffffffff);
+  this->next = (this->next + 1) % STOP_SAMPLES;
+  if (this->count < STOP_SAMPLES)
+    this->count++;
+  this->killed = false;
+}
+
+void gaggled::StopLatency::record_killed(uint64_t ms) {
+  // a kill at once says nothing about how long it would have taken.
+  if (ms > 0)
+    this->record(ms);
+  this->killed = true;
+}
+
+size_t gaggled::StopLatency::samples() {
+  return this->count;
+}
+
+uint64_t gaggled::StopLatency::percentile(double q) {
+  if (this->count == 0)
+    return 0;
+  uint32_t sorted[STOP_SAMPLES];
+  std::copy(this->ms, this->ms + this->count, sorted);
+  size_t rank = (size_t) (q * this->count + 0.999999);
+  if (rank < 1)
+    rank = 1;
+  if (rank > this->count)
+    rank = this->count;
+  std::nth_element(sorted, sorted + rank - 1, sorted + this->count);
+  return sorted[rank - 1];
+}
+
+int gaggled::StopLatency::killwait(const AdaptiveKillPolicy& policy, int configured) {
+  if (not policy.enabled or this->killed or this->count < STOP_MIN_SAMPLES)
+    return configured;
+  int max = (policy.max > 0 ? policy.max : configured);
+  double wait = policy.multiplier * this->percentile(0.99);
+  if (wait > max)
+    return max;
+  if (wait < policy.min)
+    return std::min(policy.min, max);
+  return (int) wait;
+}
@@ -0,0 +1,77 @@
+#ifndef GAGGLED_STOP_POLICY_HPP_INCLUDED
+#define GAGGLED_STOP_POLICY_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stddef.h>
+#include <stdint.h>
+
+// how many of a program's latest stops its estimates are made from, and how many it
+// takes before an adaptive killwait trusts them
+#define STOP_SAMPLES 64
+#define STOP_MIN_SAMPLES 5
+
+namespace gaggled {
+// one signal of the way a program is stopped, sent at ms after the first. a program's
+// steps are in order of at and end with SIGKILL.
+struct StopStep {
+  int signal;
+  int at;
+};
+
+// a killwait learned from how long a program has taken to exit once asked: multiplier
+// times its p99, kept between min and max ms. max 0 is the configured killwait.
+struct AdaptiveKillPolicy {
+  bool enabled;
+  double multiplier;
+  int min;
+  int max;
+};
+
+// the time between a program being sent its stop signal and dying, for its latest
+// stops. one that needed a SIGKILL counts as the time it was given, since it would have
+// taken at least that long.
+class StopLatency
+{
+public:
+  StopLatency();
+  // off, but three times the p99 from a second up to killwait once turned on.
+  static AdaptiveKillPolicy default_policy();
+  void record(uint64_t ms);
+  // a stop that was cut short by SIGKILL ms after it began. until a stop finishes on its
+  // own again killwait() is the configured one, so a program that's slowing down isn't
+  // killed again at a wait learned from when it was quicker.
+  void record_killed(uint64_t ms);
+  size_t samples();
+  // the q quantile of the samples by nearest rank, 0 with none.
+  uint64_t percentile(double q);
+  // the wait before SIGKILL under policy, or configured while too few stops are known.
+  int killwait(const AdaptiveKillPolicy& policy, int configured);
+private:
+  uint32_t ms[STOP_SAMPLES];
+  size_t count;
+  size_t next;
+  bool killed;
+};
+}
+
+#endif
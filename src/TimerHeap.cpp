@@ -0,0 +1,66 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <algorithm>
+#include "TimerHeap.hpp"
+#include "Event.hpp"
+
+namespace {
+// std heap functions build a max-heap, so order "later" events first to get the
+// soonest deadline on top.
+struct due_later {
+  bool operator() (gaggled::Event* a, gaggled::Event* b) const {
+    return b->due_before(a);
+  }
+};
+}
+
+gaggled::TimerHeap::TimerHeap() {}
+
+void gaggled::TimerHeap::push(gaggled::Event* e) {
+  heap.push_back(e);
+  std::push_heap(heap.begin(), heap.end(), due_later());
+}
+
+gaggled::Event* gaggled::TimerHeap::top() {
+  return heap.front();
+}
+
+void gaggled::TimerHeap::pop() {
+  std::pop_heap(heap.begin(), heap.end(), due_later());
+  heap.pop_back();
+}
+
+bool gaggled::TimerHeap::empty() {
+  return heap.empty();
+}
+
+size_t gaggled::TimerHeap::size() {
+  return heap.size();
+}
+
+std::vector<gaggled::Event*>& gaggled::TimerHeap::contents() {
+  return heap;
+}
+
+void gaggled::TimerHeap::reheap() {
+  std::make_heap(heap.begin(), heap.end(), due_later());
+}
@@ -0,0 +1,50 @@
+#ifndef GAGGLED_TIMERHEAP_HPP_INCLUDED
+#define GAGGLED_TIMERHEAP_HPP_INCLUDED
+
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <vector>
+
+namespace gaggled {
+class Event;
+
+// min-heap of delayed events keyed on the time they become due. events that
+// are not yet due live here instead of being re-polled in the priority queues.
+class TimerHeap
+{
+public:
+  TimerHeap();
+  void push(Event* e);
+  Event* top();
+  void pop();
+  bool empty();
+  size_t size();
+  // direct access to the heap storage, in no particular order. if the contents
+  // are modified, reheap() must be called before the next push/pop.
+  std::vector<Event*>& contents();
+  void reheap();
+private:
+  std::vector<Event*> heap;
+};
+}
+
+#endif
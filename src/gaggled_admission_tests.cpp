@@ -0,0 +1,124 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Admission.hpp"
+#include "Program.hpp"
+#include "Event.hpp"
+#include "Gaggled.hpp"
+
+using namespace gaggled;
+
+int failures = 0;
+
+// events queue themselves on a daemon when made; this one is never run. everything is
+// left for exit to clean up, since held starts are in its queues and the admission's.
+Gaggled* g = NULL;
+
+void check(bool ok, std::string what) {
+  if (not ok) {
+    std::cout << "error: " << what << std::endl;
+    failures++;
+  }
+}
+
+Program* program(std::string name, int group) {
+  std::map<std::string, std::string> env;
+  Program* p = new Program(name, "/bin/true", new std::vector<std::string>(), env, "", false, true);
+  p->set_group(group);
+  return p;
+}
+
+// one saturated group doesn't hold back starts in another group, or ungrouped ones.
+void test_saturated_group() {
+  Admission& a = *new Admission();
+  int ga = a.add_group("a", 1, 0);
+  int gb = a.add_group("b", 1, 0);
+  Program* a1 = program("a1", ga);
+  Program* a2 = program("a2", ga);
+  Program* a3 = program("a3", ga);
+  Program* b1 = program("b1", gb);
+  Program* b2 = program("b2", gb);
+  Program* loose = program("loose", -1);
+
+  check(a.admit(new StartEvent(g, a1)), "a1 should be admitted into an empty group");
+  check(not a.admit(new StartEvent(g, a2)), "a2 should be held by its full group");
+  check(not a.admit(new StartEvent(g, a3)), "a3 should be held behind a2");
+  check(a.admit(new StartEvent(g, b1)), "b1 should not wait on group a");
+  check(not a.admit(new StartEvent(g, b2)), "b2 should be held by its full group");
+  check(a.admit(new StartEvent(g, loose)), "an ungrouped start should not wait on any group");
+  check(a.held_count() == 3, "a2, a3 and b2 should be held");
+}
+
+// with a global limit, starts held only by their own group don't block the rest, but a
+// start waiting for a global slot does.
+void test_global_slot() {
+  Admission a;
+  a.set_global(3, 0);
+  int ga = a.add_group("a", 1, 0);
+  int gb = a.add_group("b", 0, 0);
+  Program* a1 = program("a1", ga);
+  Program* a2 = program("a2", ga);
+  Program* b1 = program("b1", gb);
+  Program* b2 = program("b2", gb);
+  Program* b3 = program("b3", gb);
+  Program* loose = program("loose", -1);
+
+  check(a.admit(new StartEvent(g, a1)), "a1 should be admitted");
+  check(not a.admit(new StartEvent(g, a2)), "a2 should be held by its full group");
+  check(a.admit(new StartEvent(g, b1)), "b1 should not wait on group a");
+  check(a.admit(new StartEvent(g, b2)), "b2 should take the last global slot");
+  check(not a.admit(new StartEvent(g, b3)), "b3 should be held by the global limit");
+  a.forfeit(b2);
+  check(not a.admit(new StartEvent(g, loose)), "a start should not jump b3 for the freed global slot");
+  check(a.held_count() == 3, "a2, b3 and loose should be held");
+}
+
+int main(int argc, char** argv) {
+  char conf[] = "/tmp/gaggled_admission_tests.XXXXXX";
+  int fd = mkstemp(conf);
+  if (fd == -1) {
+    std::cout << "error: could not make a config file." << std::endl;
+    return 1;
+  }
+  close(fd);
+  std::ofstream out(conf);
+  out << "gaggled {\n  eventurl tcp://*:3456\n  controlurl tcp://*:3457\n}\n";
+  out.close();
+  g = new Gaggled(conf);
+  unlink(conf);
+
+  test_saturated_group();
+  test_global_slot();
+  if (failures != 0) {
+    std::cout << failures << " admission checks failed." << std::endl;
+    return 1;
+  }
+  std::cout << "admission checks passed." << std::endl;
+  return 0;
+}
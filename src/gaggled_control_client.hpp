@@ -15,7 +15,7 @@ namespace gaggled_control_client {
     const uint8_t ST_AFFIRM = 0;
     const uint8_t ST_BADMSG = 1;
     const uint8_t ST_FAILED = 2;
-    const uint32_t WIRE_VERSION = 5238;
+    const uint32_t WIRE_VERSION = 5243;
     const uint32_t FNUM_GETSTATES = 1;
     const uint32_t FNUM_KILL = 2;
     const uint32_t FNUM_SHUTDOWN = 3;
@@ -50,13 +50,22 @@ namespace gaggled_control_client {
     public:
      // functions
      // members
+      uint64_t backoff_ms;
+      uint32_t churn_deaths;
+      uint8_t churning;
       uint8_t dependencies_satisfied;
       std::string down_type;
       uint8_t during_shutdown;
       uint8_t is_operator_shutdown;
+      uint64_t killwait_ms;
       int64_t pid;
       std::string program;
       uint64_t state_sequence;
+      uint64_t stop_budget_ms;
+      uint8_t stop_overran;
+      uint64_t stop_p50_ms;
+      uint64_t stop_p99_ms;
+      uint32_t stop_samples;
       uint8_t up;
       uint64_t uptime_ms;
     };
@@ -192,6 +201,24 @@ namespace gaggled_control_client {
         }
         for (uint32_t blidx=0; (blidx < blsize); blidx = (blidx + 1)) {
           ProgramState rd;
+          if ((buf_size >= ((*(buf_offset)) + 8))) {
+            rd.backoff_ms = ((((uint64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((uint64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((uint64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((uint64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((uint64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((uint64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((uint64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((uint64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
+            (*(buf_offset)) = ((*(buf_offset)) + 8);
+          } else {
+            throw BadMessage();
+          }
+          if ((buf_size >= ((*(buf_offset)) + 4))) {
+            rd.churn_deaths = ((((uint32_t)(inbuf[((*(buf_offset)) + 0)])) << 24) + ((((uint32_t)(inbuf[((*(buf_offset)) + 1)])) << 16) + ((((uint32_t)(inbuf[((*(buf_offset)) + 2)])) << 8) + (((uint32_t)(inbuf[((*(buf_offset)) + 3)])) << 0))));
+            (*(buf_offset)) = ((*(buf_offset)) + 4);
+          } else {
+            throw BadMessage();
+          }
+          if ((buf_size >= ((*(buf_offset)) + 1))) {
+            rd.churning = (((uint8_t)(inbuf[((*(buf_offset)) + 0)])) << 0);
+            (*(buf_offset)) = ((*(buf_offset)) + 1);
+          } else {
+            throw BadMessage();
+          }
           if ((buf_size >= ((*(buf_offset)) + 1))) {
             rd.dependencies_satisfied = (((uint8_t)(inbuf[((*(buf_offset)) + 0)])) << 0);
             (*(buf_offset)) = ((*(buf_offset)) + 1);
@@ -223,6 +250,12 @@ namespace gaggled_control_client {
           } else {
             throw BadMessage();
           }
+          if ((buf_size >= ((*(buf_offset)) + 8))) {
+            rd.killwait_ms = ((((uint64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((uint64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((uint64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((uint64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((uint64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((uint64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((uint64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((uint64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
+            (*(buf_offset)) = ((*(buf_offset)) + 8);
+          } else {
+            throw BadMessage();
+          }
           if ((buf_size >= ((*(buf_offset)) + 8))) {
             rd.pid = ((((int64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((int64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((int64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((int64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((int64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((int64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((int64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((int64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
             (*(buf_offset)) = ((*(buf_offset)) + 8);
@@ -248,6 +281,36 @@ namespace gaggled_control_client {
           } else {
             throw BadMessage();
           }
+          if ((buf_size >= ((*(buf_offset)) + 8))) {
+            rd.stop_budget_ms = ((((uint64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((uint64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((uint64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((uint64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((uint64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((uint64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((uint64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((uint64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
+            (*(buf_offset)) = ((*(buf_offset)) + 8);
+          } else {
+            throw BadMessage();
+          }
+          if ((buf_size >= ((*(buf_offset)) + 1))) {
+            rd.stop_overran = (((uint8_t)(inbuf[((*(buf_offset)) + 0)])) << 0);
+            (*(buf_offset)) = ((*(buf_offset)) + 1);
+          } else {
+            throw BadMessage();
+          }
+          if ((buf_size >= ((*(buf_offset)) + 8))) {
+            rd.stop_p50_ms = ((((uint64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((uint64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((uint64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((uint64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((uint64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((uint64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((uint64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((uint64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
+            (*(buf_offset)) = ((*(buf_offset)) + 8);
+          } else {
+            throw BadMessage();
+          }
+          if ((buf_size >= ((*(buf_offset)) + 8))) {
+            rd.stop_p99_ms = ((((uint64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((uint64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((uint64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((uint64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((uint64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((uint64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((uint64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((uint64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
+            (*(buf_offset)) = ((*(buf_offset)) + 8);
+          } else {
+            throw BadMessage();
+          }
+          if ((buf_size >= ((*(buf_offset)) + 4))) {
+            rd.stop_samples = ((((uint32_t)(inbuf[((*(buf_offset)) + 0)])) << 24) + ((((uint32_t)(inbuf[((*(buf_offset)) + 1)])) << 16) + ((((uint32_t)(inbuf[((*(buf_offset)) + 2)])) << 8) + (((uint32_t)(inbuf[((*(buf_offset)) + 3)])) << 0))));
+            (*(buf_offset)) = ((*(buf_offset)) + 4);
+          } else {
+            throw BadMessage();
+          }
           if ((buf_size >= ((*(buf_offset)) + 1))) {
             rd.up = (((uint8_t)(inbuf[((*(buf_offset)) + 0)])) << 0);
             (*(buf_offset)) = ((*(buf_offset)) + 1);
@@ -275,6 +338,22 @@ namespace gaggled_control_client {
         outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((listsize >> 0) & 255)));
         (*(buf_offset)) = ((*(buf_offset)) + 4);
         for (uint32_t listoffset=0; (listoffset < listsize); listoffset = (listoffset + 1)) {
+          outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].backoff_ms >> 56) & 255)));
+          outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj[listoffset].backoff_ms >> 48) & 255)));
+          outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj[listoffset].backoff_ms >> 40) & 255)));
+          outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj[listoffset].backoff_ms >> 32) & 255)));
+          outbuf[((*(buf_offset)) + 4)] = ((uint8_t)(((obj[listoffset].backoff_ms >> 24) & 255)));
+          outbuf[((*(buf_offset)) + 5)] = ((uint8_t)(((obj[listoffset].backoff_ms >> 16) & 255)));
+          outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj[listoffset].backoff_ms >> 8) & 255)));
+          outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj[listoffset].backoff_ms >> 0) & 255)));
+          (*(buf_offset)) = ((*(buf_offset)) + 8);
+          outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].churn_deaths >> 24) & 255)));
+          outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj[listoffset].churn_deaths >> 16) & 255)));
+          outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj[listoffset].churn_deaths >> 8) & 255)));
+          outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj[listoffset].churn_deaths >> 0) & 255)));
+          (*(buf_offset)) = ((*(buf_offset)) + 4);
+          outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].churning >> 0) & 255)));
+          (*(buf_offset)) = ((*(buf_offset)) + 1);
           outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].dependencies_satisfied >> 0) & 255)));
           (*(buf_offset)) = ((*(buf_offset)) + 1);
           uint32_t lencache=((&(obj[listoffset].down_type)))->length();
@@ -292,6 +371,15 @@ namespace gaggled_control_client {
           (*(buf_offset)) = ((*(buf_offset)) + 1);
           outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].is_operator_shutdown >> 0) & 255)));
           (*(buf_offset)) = ((*(buf_offset)) + 1);
+          outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].killwait_ms >> 56) & 255)));
+          outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj[listoffset].killwait_ms >> 48) & 255)));
+          outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj[listoffset].killwait_ms >> 40) & 255)));
+          outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj[listoffset].killwait_ms >> 32) & 255)));
+          outbuf[((*(buf_offset)) + 4)] = ((uint8_t)(((obj[listoffset].killwait_ms >> 24) & 255)));
+          outbuf[((*(buf_offset)) + 5)] = ((uint8_t)(((obj[listoffset].killwait_ms >> 16) & 255)));
+          outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj[listoffset].killwait_ms >> 8) & 255)));
+          outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj[listoffset].killwait_ms >> 0) & 255)));
+          (*(buf_offset)) = ((*(buf_offset)) + 8);
           outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].pid >> 56) & 255)));
           outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj[listoffset].pid >> 48) & 255)));
           outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj[listoffset].pid >> 40) & 255)));
@@ -321,6 +409,40 @@ namespace gaggled_control_client {
           outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj[listoffset].state_sequence >> 8) & 255)));
           outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj[listoffset].state_sequence >> 0) & 255)));
           (*(buf_offset)) = ((*(buf_offset)) + 8);
+          outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].stop_budget_ms >> 56) & 255)));
+          outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj[listoffset].stop_budget_ms >> 48) & 255)));
+          outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj[listoffset].stop_budget_ms >> 40) & 255)));
+          outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj[listoffset].stop_budget_ms >> 32) & 255)));
+          outbuf[((*(buf_offset)) + 4)] = ((uint8_t)(((obj[listoffset].stop_budget_ms >> 24) & 255)));
+          outbuf[((*(buf_offset)) + 5)] = ((uint8_t)(((obj[listoffset].stop_budget_ms >> 16) & 255)));
+          outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj[listoffset].stop_budget_ms >> 8) & 255)));
+          outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj[listoffset].stop_budget_ms >> 0) & 255)));
+          (*(buf_offset)) = ((*(buf_offset)) + 8);
+          outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].stop_overran >> 0) & 255)));
+          (*(buf_offset)) = ((*(buf_offset)) + 1);
+          outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].stop_p50_ms >> 56) & 255)));
+          outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj[listoffset].stop_p50_ms >> 48) & 255)));
+          outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj[listoffset].stop_p50_ms >> 40) & 255)));
+          outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj[listoffset].stop_p50_ms >> 32) & 255)));
+          outbuf[((*(buf_offset)) + 4)] = ((uint8_t)(((obj[listoffset].stop_p50_ms >> 24) & 255)));
+          outbuf[((*(buf_offset)) + 5)] = ((uint8_t)(((obj[listoffset].stop_p50_ms >> 16) & 255)));
+          outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj[listoffset].stop_p50_ms >> 8) & 255)));
+          outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj[listoffset].stop_p50_ms >> 0) & 255)));
+          (*(buf_offset)) = ((*(buf_offset)) + 8);
+          outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].stop_p99_ms >> 56) & 255)));
+          outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj[listoffset].stop_p99_ms >> 48) & 255)));
+          outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj[listoffset].stop_p99_ms >> 40) & 255)));
+          outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj[listoffset].stop_p99_ms >> 32) & 255)));
+          outbuf[((*(buf_offset)) + 4)] = ((uint8_t)(((obj[listoffset].stop_p99_ms >> 24) & 255)));
+          outbuf[((*(buf_offset)) + 5)] = ((uint8_t)(((obj[listoffset].stop_p99_ms >> 16) & 255)));
+          outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj[listoffset].stop_p99_ms >> 8) & 255)));
+          outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj[listoffset].stop_p99_ms >> 0) & 255)));
+          (*(buf_offset)) = ((*(buf_offset)) + 8);
+          outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].stop_samples >> 24) & 255)));
+          outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj[listoffset].stop_samples >> 16) & 255)));
+          outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj[listoffset].stop_samples >> 8) & 255)));
+          outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj[listoffset].stop_samples >> 0) & 255)));
+          (*(buf_offset)) = ((*(buf_offset)) + 4);
           outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].up >> 0) & 255)));
           (*(buf_offset)) = ((*(buf_offset)) + 1);
           outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj[listoffset].uptime_ms >> 56) & 255)));
@@ -544,7 +666,7 @@ namespace gaggled_control_client {
       }
      // members
       bool ctx_created;
-      uint8_t msgbuf[302092];
+      uint8_t msgbuf[353292];
       uint32_t msgbuf_s;
     };
 }
@@ -270,6 +270,10 @@ int main(int argc, char** argv) {
         std::cout << "UP";
         if (!printjson)
           std::cout << "    ";
+      } else if (p->churning == 1) {
+        std::cout << "CHURN";
+        if (!printjson)
+          std::cout << " ";
       } else {
         std::cout << "DOWN";
         if (!printjson)
@@ -283,6 +287,13 @@ int main(int argc, char** argv) {
       else
         std::cout << "\"," << std::endl;
 
+      if (printjson) {
+        std::cout << "    \"killwait_ms\" : " << p->killwait_ms << "," << std::endl;
+        std::cout << "    \"stop_samples\" : " << p->stop_samples << "," << std::endl;
+        std::cout << "    \"stop_p50_ms\" : " << p->stop_p50_ms << "," << std::endl;
+        std::cout << "    \"stop_p99_ms\" : " << p->stop_p99_ms << "," << std::endl;
+      }
+
       if (printjson)
         std::cout << "    \"program\" : \"";
 
@@ -367,12 +378,25 @@ int main(int argc, char** argv) {
           }
 
           if (printjson)
-            std::cout << "\"" << std::endl;
+            std::cout << "\"";
         } else if (printjson) {
-          std::cout << "\"" << std::endl;
+          std::cout << "\"";
         }
+
+        if (p->backoff_ms != 0) {
+          if (!printjson)
+            std::cout << ((dns or dt) ? ", " : "") << "respawning after " << p->backoff_ms << "ms backoff";
+          else
+            std::cout << "," << std::endl << "    \"backoff_ms\" : " << p->backoff_ms;
+        }
+
+        if (printjson)
+          std::cout << std::endl;
       }
 
+      if (!printjson and p->stop_samples != 0)
+        std::cout << " (stops: p50 " << p->stop_p50_ms << "ms, p99 " << p->stop_p99_ms << "ms of " << p->stop_samples << ", killwait " << p->killwait_ms << "ms)";
+
       if (printjson)
         std::cout << "  }";
       else
@@ -12,7 +12,7 @@
 
 namespace gaggled_events_server {
 
-    const uint32_t WIRE_VERSION = 9237;
+    const uint32_t WIRE_VERSION = 9242;
     const uint32_t FNUM_DUMPED = 1;
     const uint32_t FNUM_STATECHANGE = 2;
 
@@ -26,13 +26,22 @@ namespace gaggled_events_server {
     public:
      // functions
      // members
+      uint64_t backoff_ms;
+      uint32_t churn_deaths;
+      uint8_t churning;
       uint8_t dependencies_satisfied;
       std::string down_type;
       uint8_t during_shutdown;
       uint8_t is_operator_shutdown;
+      uint64_t killwait_ms;
       int64_t pid;
       std::string program;
       uint64_t state_sequence;
+      uint64_t stop_budget_ms;
+      uint8_t stop_overran;
+      uint64_t stop_p50_ms;
+      uint64_t stop_p99_ms;
+      uint32_t stop_samples;
       uint8_t up;
       uint64_t uptime_ms;
     };
@@ -92,6 +101,24 @@ namespace gaggled_events_server {
         char vchar_buf[256];
         uint32_t vchar_size;
         ProgramState ret;
+        if ((buf_size >= ((*(buf_offset)) + 8))) {
+          ret.backoff_ms = ((((uint64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((uint64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((uint64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((uint64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((uint64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((uint64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((uint64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((uint64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
+          (*(buf_offset)) = ((*(buf_offset)) + 8);
+        } else {
+          throw BadMessage();
+        }
+        if ((buf_size >= ((*(buf_offset)) + 4))) {
+          ret.churn_deaths = ((((uint32_t)(inbuf[((*(buf_offset)) + 0)])) << 24) + ((((uint32_t)(inbuf[((*(buf_offset)) + 1)])) << 16) + ((((uint32_t)(inbuf[((*(buf_offset)) + 2)])) << 8) + (((uint32_t)(inbuf[((*(buf_offset)) + 3)])) << 0))));
+          (*(buf_offset)) = ((*(buf_offset)) + 4);
+        } else {
+          throw BadMessage();
+        }
+        if ((buf_size >= ((*(buf_offset)) + 1))) {
+          ret.churning = (((uint8_t)(inbuf[((*(buf_offset)) + 0)])) << 0);
+          (*(buf_offset)) = ((*(buf_offset)) + 1);
+        } else {
+          throw BadMessage();
+        }
         if ((buf_size >= ((*(buf_offset)) + 1))) {
           ret.dependencies_satisfied = (((uint8_t)(inbuf[((*(buf_offset)) + 0)])) << 0);
           (*(buf_offset)) = ((*(buf_offset)) + 1);
@@ -123,6 +150,12 @@ namespace gaggled_events_server {
         } else {
           throw BadMessage();
         }
+        if ((buf_size >= ((*(buf_offset)) + 8))) {
+          ret.killwait_ms = ((((uint64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((uint64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((uint64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((uint64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((uint64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((uint64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((uint64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((uint64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
+          (*(buf_offset)) = ((*(buf_offset)) + 8);
+        } else {
+          throw BadMessage();
+        }
         if ((buf_size >= ((*(buf_offset)) + 8))) {
           ret.pid = ((((int64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((int64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((int64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((int64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((int64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((int64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((int64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((int64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
           (*(buf_offset)) = ((*(buf_offset)) + 8);
@@ -148,6 +181,36 @@ namespace gaggled_events_server {
         } else {
           throw BadMessage();
         }
+        if ((buf_size >= ((*(buf_offset)) + 8))) {
+          ret.stop_budget_ms = ((((uint64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((uint64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((uint64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((uint64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((uint64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((uint64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((uint64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((uint64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
+          (*(buf_offset)) = ((*(buf_offset)) + 8);
+        } else {
+          throw BadMessage();
+        }
+        if ((buf_size >= ((*(buf_offset)) + 1))) {
+          ret.stop_overran = (((uint8_t)(inbuf[((*(buf_offset)) + 0)])) << 0);
+          (*(buf_offset)) = ((*(buf_offset)) + 1);
+        } else {
+          throw BadMessage();
+        }
+        if ((buf_size >= ((*(buf_offset)) + 8))) {
+          ret.stop_p50_ms = ((((uint64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((uint64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((uint64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((uint64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((uint64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((uint64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((uint64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((uint64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
+          (*(buf_offset)) = ((*(buf_offset)) + 8);
+        } else {
+          throw BadMessage();
+        }
+        if ((buf_size >= ((*(buf_offset)) + 8))) {
+          ret.stop_p99_ms = ((((uint64_t)(inbuf[((*(buf_offset)) + 0)])) << 56) + ((((uint64_t)(inbuf[((*(buf_offset)) + 1)])) << 48) + ((((uint64_t)(inbuf[((*(buf_offset)) + 2)])) << 40) + ((((uint64_t)(inbuf[((*(buf_offset)) + 3)])) << 32) + ((((uint64_t)(inbuf[((*(buf_offset)) + 4)])) << 24) + ((((uint64_t)(inbuf[((*(buf_offset)) + 5)])) << 16) + ((((uint64_t)(inbuf[((*(buf_offset)) + 6)])) << 8) + (((uint64_t)(inbuf[((*(buf_offset)) + 7)])) << 0))))))));
+          (*(buf_offset)) = ((*(buf_offset)) + 8);
+        } else {
+          throw BadMessage();
+        }
+        if ((buf_size >= ((*(buf_offset)) + 4))) {
+          ret.stop_samples = ((((uint32_t)(inbuf[((*(buf_offset)) + 0)])) << 24) + ((((uint32_t)(inbuf[((*(buf_offset)) + 1)])) << 16) + ((((uint32_t)(inbuf[((*(buf_offset)) + 2)])) << 8) + (((uint32_t)(inbuf[((*(buf_offset)) + 3)])) << 0))));
+          (*(buf_offset)) = ((*(buf_offset)) + 4);
+        } else {
+          throw BadMessage();
+        }
         if ((buf_size >= ((*(buf_offset)) + 1))) {
           ret.up = (((uint8_t)(inbuf[((*(buf_offset)) + 0)])) << 0);
           (*(buf_offset)) = ((*(buf_offset)) + 1);
@@ -163,6 +226,22 @@ namespace gaggled_events_server {
         return ret;
       }
       void encode_ProgramState (uint8_t* outbuf, uint32_t* buf_offset, ProgramState& obj) {
+        outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.backoff_ms >> 56) & 255)));
+        outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj.backoff_ms >> 48) & 255)));
+        outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj.backoff_ms >> 40) & 255)));
+        outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj.backoff_ms >> 32) & 255)));
+        outbuf[((*(buf_offset)) + 4)] = ((uint8_t)(((obj.backoff_ms >> 24) & 255)));
+        outbuf[((*(buf_offset)) + 5)] = ((uint8_t)(((obj.backoff_ms >> 16) & 255)));
+        outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj.backoff_ms >> 8) & 255)));
+        outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj.backoff_ms >> 0) & 255)));
+        (*(buf_offset)) = ((*(buf_offset)) + 8);
+        outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.churn_deaths >> 24) & 255)));
+        outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj.churn_deaths >> 16) & 255)));
+        outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj.churn_deaths >> 8) & 255)));
+        outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj.churn_deaths >> 0) & 255)));
+        (*(buf_offset)) = ((*(buf_offset)) + 4);
+        outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.churning >> 0) & 255)));
+        (*(buf_offset)) = ((*(buf_offset)) + 1);
         outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.dependencies_satisfied >> 0) & 255)));
         (*(buf_offset)) = ((*(buf_offset)) + 1);
         uint32_t lencache=((&(obj.down_type)))->length();
@@ -180,6 +259,15 @@ namespace gaggled_events_server {
         (*(buf_offset)) = ((*(buf_offset)) + 1);
         outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.is_operator_shutdown >> 0) & 255)));
         (*(buf_offset)) = ((*(buf_offset)) + 1);
+        outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.killwait_ms >> 56) & 255)));
+        outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj.killwait_ms >> 48) & 255)));
+        outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj.killwait_ms >> 40) & 255)));
+        outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj.killwait_ms >> 32) & 255)));
+        outbuf[((*(buf_offset)) + 4)] = ((uint8_t)(((obj.killwait_ms >> 24) & 255)));
+        outbuf[((*(buf_offset)) + 5)] = ((uint8_t)(((obj.killwait_ms >> 16) & 255)));
+        outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj.killwait_ms >> 8) & 255)));
+        outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj.killwait_ms >> 0) & 255)));
+        (*(buf_offset)) = ((*(buf_offset)) + 8);
         outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.pid >> 56) & 255)));
         outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj.pid >> 48) & 255)));
         outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj.pid >> 40) & 255)));
@@ -209,6 +297,40 @@ namespace gaggled_events_server {
         outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj.state_sequence >> 8) & 255)));
         outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj.state_sequence >> 0) & 255)));
         (*(buf_offset)) = ((*(buf_offset)) + 8);
+        outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.stop_budget_ms >> 56) & 255)));
+        outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj.stop_budget_ms >> 48) & 255)));
+        outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj.stop_budget_ms >> 40) & 255)));
+        outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj.stop_budget_ms >> 32) & 255)));
+        outbuf[((*(buf_offset)) + 4)] = ((uint8_t)(((obj.stop_budget_ms >> 24) & 255)));
+        outbuf[((*(buf_offset)) + 5)] = ((uint8_t)(((obj.stop_budget_ms >> 16) & 255)));
+        outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj.stop_budget_ms >> 8) & 255)));
+        outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj.stop_budget_ms >> 0) & 255)));
+        (*(buf_offset)) = ((*(buf_offset)) + 8);
+        outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.stop_overran >> 0) & 255)));
+        (*(buf_offset)) = ((*(buf_offset)) + 1);
+        outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.stop_p50_ms >> 56) & 255)));
+        outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj.stop_p50_ms >> 48) & 255)));
+        outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj.stop_p50_ms >> 40) & 255)));
+        outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj.stop_p50_ms >> 32) & 255)));
+        outbuf[((*(buf_offset)) + 4)] = ((uint8_t)(((obj.stop_p50_ms >> 24) & 255)));
+        outbuf[((*(buf_offset)) + 5)] = ((uint8_t)(((obj.stop_p50_ms >> 16) & 255)));
+        outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj.stop_p50_ms >> 8) & 255)));
+        outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj.stop_p50_ms >> 0) & 255)));
+        (*(buf_offset)) = ((*(buf_offset)) + 8);
+        outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.stop_p99_ms >> 56) & 255)));
+        outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj.stop_p99_ms >> 48) & 255)));
+        outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj.stop_p99_ms >> 40) & 255)));
+        outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj.stop_p99_ms >> 32) & 255)));
+        outbuf[((*(buf_offset)) + 4)] = ((uint8_t)(((obj.stop_p99_ms >> 24) & 255)));
+        outbuf[((*(buf_offset)) + 5)] = ((uint8_t)(((obj.stop_p99_ms >> 16) & 255)));
+        outbuf[((*(buf_offset)) + 6)] = ((uint8_t)(((obj.stop_p99_ms >> 8) & 255)));
+        outbuf[((*(buf_offset)) + 7)] = ((uint8_t)(((obj.stop_p99_ms >> 0) & 255)));
+        (*(buf_offset)) = ((*(buf_offset)) + 8);
+        outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.stop_samples >> 24) & 255)));
+        outbuf[((*(buf_offset)) + 1)] = ((uint8_t)(((obj.stop_samples >> 16) & 255)));
+        outbuf[((*(buf_offset)) + 2)] = ((uint8_t)(((obj.stop_samples >> 8) & 255)));
+        outbuf[((*(buf_offset)) + 3)] = ((uint8_t)(((obj.stop_samples >> 0) & 255)));
+        (*(buf_offset)) = ((*(buf_offset)) + 4);
         outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.up >> 0) & 255)));
         (*(buf_offset)) = ((*(buf_offset)) + 1);
         outbuf[((*(buf_offset)) + 0)] = ((uint8_t)(((obj.uptime_ms >> 56) & 255)));
@@ -259,7 +381,7 @@ namespace gaggled_events_server {
       }
      // members
       bool ctx_created;
-      uint8_t msgbuf[303];
+      uint8_t msgbuf[353];
       uint32_t msgbuf_s;
     };
 }
@@ -14,10 +14,12 @@ class GaggledWatcher : public gaggled_events_client::gaggled_events<GaggledWatch
     
   }
   void handle_statechange(gaggled_events_client::ProgramState& obj) {
-    if (obj.up == 1) {
+    if (obj.up == 1 and obj.stop_overran == 1) {
+      std::cout << "[U overran=" << obj.stop_budget_ms << "ms] " << obj.program << std::endl;
+    } else if (obj.up == 1) {
       std::cout << "[U] " << obj.program << std::endl;
     } else {
-      std::cout << "[D shutdown=" << int(obj.during_shutdown) << " dtyp=" << obj.down_type << " depsat=" << int(obj.dependencies_satisfied) << " opdown=" << int(obj.is_operator_shutdown) << "] " << obj.program << std::endl;
+      std::cout << "[D shutdown=" << int(obj.during_shutdown) << " dtyp=" << obj.down_type << " depsat=" << int(obj.dependencies_satisfied) << " opdown=" << int(obj.is_operator_shutdown) << " overran=" << int(obj.stop_overran) << "] " << obj.program << std::endl;
     }
   }
 };
@@ -46,6 +46,11 @@ void die_callback(int a) {
   g->stop();
 }
 
+void report_callback(int a) {
+  if (g != NULL)
+    g->request_report();
+}
+
 void usage() {
   std::cout << "gaggled v" << gaggled::version << ", process manager for running a gaggle of daemons." << std::endl << std::endl;
   std::cout << "usage: gaggled (-h|-c <file> [-t])" << std::endl;
@@ -53,6 +58,7 @@ void usage() {
   std::cout << "\t-h to show help." << std::endl;
   std::cout << "\t-t to only test the configuration rather than running it." << std::endl;
   std::cout << "\t-n to disable ^c on the terminal (or SIGINT) from shutting down gaggled. Shutdown should be accomplished by sending SIGTERM in this case." << std::endl;
+  std::cout << "\tSIGUSR1 makes a running gaggled print its internal counters." << std::endl;
 }
 
 int main(int argc, char** argv) {
@@ -117,6 +123,7 @@ int main(int argc, char** argv) {
   }
 
   signal(SIGTERM, die_callback);
+  signal(SIGUSR1, report_callback);
   if (ign_sigint)
     signal(SIGINT, SIG_IGN);
   else 
@@ -109,11 +109,33 @@ typedef std::pair<boost::system_time, gaggled_events_client::ProgramState> stamp
 
     // !CHURN -> CHURN?
     /*
-     * CHURN indicates that the program has crashed more than once.  Incorrectly stating that a program is in CHURN can result in 
+     * CHURN indicates that the program is dying over and over.  When gaggled is looking for that itself (churndeaths), it has
+     * seen the program die too often lately and paused restarting it, and says so in the states it publishes.
+     */
+    if (announced_state != STATE_CHURN && last.second.churn_deaths > 0) {
+      int states = inbound_program_states.size();
+      for (int i = states - 1; i >= 0; i--) {
+        if (inbound_program_states[i].second.churning == 1) {
+          // What did we base our last statement on, and when did we get it?
+          announced_time = inbound_program_states[i].first;
+          announced_program_state = inbound_program_states[i].second;
+
+          // try to find the last used pid in the inbound states before clearing
+          find_last_pid();
+
+          // save only what came after it
+          inbound_program_states.erase(inbound_program_states.begin(), inbound_program_states.begin() + i + 1);
+          return (announced_state = STATE_CHURN);
+        }
+      }
+    }
+
+    /*
+     * Otherwise we guess from the pattern of ups and downs.  Incorrectly stating that a program is in CHURN can result in
      * confusion for the sysadmin; so we must condition entering CHURN on there being more than two state changes; just two could indicate
      * a program crashed once and recovered.
      */
-    if (announced_state != STATE_CHURN) {
+    if (announced_state != STATE_CHURN && last.second.churn_deaths == 0) {
       int states = inbound_program_states.size();
       if (states > 2) {
         int ups = 0;
@@ -187,7 +209,7 @@ typedef std::pair<boost::system_time, gaggled_events_client::ProgramState> stamp
 
     // CHURN -> (UP | DOWN)    
     if (announced_state == STATE_CHURN) {
-      if (last.first + boost::posix_time::milliseconds(period) < boost::get_system_time()) {
+      if (last.second.churning == 0 && last.first + boost::posix_time::milliseconds(period) < boost::get_system_time()) {
         // What did we base our last statement on, and when did we get it?
         announced_time = last.first;
         announced_program_state = last.second;
@@ -226,6 +248,7 @@ typedef std::pair<boost::system_time, gaggled_events_client::ProgramState> stamp
       for (size_t i = states - show; i < states; i++)
         {
         std::cout << "program=" << inbound_program_states[i].second.program;
+        std::cout << " churning=" << int(inbound_program_states[i].second.churning);
         std::cout << " dependencies_satisfied=" << int(inbound_program_states[i].second.dependencies_satisfied);
         std::cout << " is_operator_shutdown=" << int(inbound_program_states[i].second.is_operator_shutdown);
         std::cout << " during_shutdown=" << int(inbound_program_states[i].second.during_shutdown);
@@ -295,6 +318,15 @@ typedef std::pair<boost::system_time, gaggled_events_client::ProgramState> stamp
     pe.down_type = ps.down_type;
     pe.pid = ps.pid;
     pe.uptime_ms = ps.uptime_ms;
+    pe.backoff_ms = ps.backoff_ms;
+    pe.churn_deaths = ps.churn_deaths;
+    pe.churning = ps.churning;
+    pe.stop_budget_ms = ps.stop_budget_ms;
+    pe.stop_overran = ps.stop_overran;
+    pe.killwait_ms = ps.killwait_ms;
+    pe.stop_samples = ps.stop_samples;
+    pe.stop_p50_ms = ps.stop_p50_ms;
+    pe.stop_p99_ms = ps.stop_p99_ms;
 
     update(pe);
   }
@@ -0,0 +1,97 @@
+// L I C E N S E #############################################################//
+
+/*
+ *  Copyright 2011 BigWells Technology (Zen-Fire)
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// I N C L U D E S ###########################################################//
+
+
+#include <iostream>
+#include <string>
+
+#include "StopPolicy.hpp"
+
+using namespace gaggled;
+
+int failures = 0;
+
+void check(bool ok, std::string what) {
+  if (not ok) {
+    std::cout << "error: " << what << std::endl;
+    failures++;
+  }
+}
+
+AdaptiveKillPolicy policy() {
+  AdaptiveKillPolicy policy = StopLatency::default_policy();
+  policy.enabled = true;
+  return policy;
+}
+
+// stops the program as its latencies say, killing any that outlast the learned wait,
+// and returns how many were killed.
+int stop(StopLatency& s, const AdaptiveKillPolicy& policy, int configured, int latency, int times) {
+  int kills = 0;
+  for (int i = 0; i != times; i++) {
+    int wait = s.killwait(policy, configured);
+    if (latency > wait) {
+      s.record_killed(wait);
+      kills++;
+    } else {
+      s.record(latency);
+    }
+  }
+  return kills;
+}
+
+// a program that gets slower is killed once, not every time from then on.
+void test_increasing_latency() {
+  StopLatency s;
+  AdaptiveKillPolicy p = policy();
+  check(stop(s, p, 10000, 100, 10) == 0, "quick stops should not be killed");
+  check(s.killwait(p, 10000) == 1000, "quick stops should learn the minimum killwait");
+  check(stop(s, p, 10000, 4000, 10) == 1, "a slower program should be killed only once");
+  check(s.killwait(p, 10000) == 10000, "the slower stops should raise the killwait");
+}
+
+// a killed stop counts as at least the wait it was given, and the wait after it is the
+// configured one.
+void test_killed_stop() {
+  StopLatency s;
+  AdaptiveKillPolicy p = policy();
+  p.min = 100;
+  stop(s, p, 10000, 200, 5);
+  check(s.killwait(p, 10000) == 600, "five stops should learn a killwait");
+  s.record_killed(600);
+  check(s.killwait(p, 10000) == 10000, "the stop after a kill should wait the configured killwait");
+  check(s.percentile(0.99) == 600, "a killed stop should count as the wait it was given");
+  s.record(200);
+  check(s.killwait(p, 10000) == 1800, "a killed stop should not lower the learned killwait");
+  s.record_killed(0);
+  check(s.samples() == 7, "an immediate kill should not be a sample");
+}
+
+int main(int argc, char** argv) {
+  test_increasing_latency();
+  test_killed_stop();
+  if (failures != 0) {
+    std::cout << failures << " stop latency checks failed." << std::endl;
+    return 1;
+  }
+  std::cout << "stop latency checks passed." << std::endl;
+  return 0;
+}